@@ -1,6 +1,11 @@
 #pragma once
 
+#include "detail/keyword_map.hpp"
+#include "detail/no_spec_formatter.hpp"
+
 #include <chrono>
+#include <fmt/format.h>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -11,6 +16,22 @@ namespace ext::chrono {
 
     enum time_type { gmt, local };
 
+    namespace detail {
+        constexpr auto time_type_keywords = make_keyword_map<time_type>({
+            {"gmt", gmt},
+            {"local", local},
+        });
+    }
+
+    /**
+     * Returns the time type named "gmt" or "local", or nothing if the name is
+     * not recognized.
+     */
+    constexpr auto parse_time_type(std::string_view name)
+        -> std::optional<time_type> {
+        return detail::time_type_keywords.find(name);
+    }
+
     class timestamp {
         std::string m_format;
         time_point m_time;
@@ -18,7 +39,7 @@ namespace ext::chrono {
     public:
         timestamp(std::string_view format, time_type type);
 
-        auto format() const -> std::string;
+        auto format() const -> const std::string&;
         auto strftime(int buffer_size) const -> std::string;
         auto time() const -> time_point;
         auto type() const -> time_type;
@@ -26,3 +47,12 @@ namespace ext::chrono {
 
     auto operator<<(std::ostream& os, const timestamp& ts) -> std::ostream&;
 }
+
+/**
+ * Formats a timestamp according to its strftime format string.
+ */
+template <>
+struct fmt::formatter<ext::chrono::timestamp> : ext::detail::no_spec_formatter {
+    auto format(const ext::chrono::timestamp& ts, format_context& ctx) const
+        -> decltype(ctx.out());
+};
@@ -1,10 +1,17 @@
 #pragma once
 
+#include "detail/keyword_map.hpp"
+
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <fmt/format.h>
+#include <optional>
 #include <ostream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 
 namespace ext {
     constexpr auto byte_unit_max = 1'024u;
@@ -18,6 +25,53 @@ namespace ext {
         byte_multiple::GiB,
         byte_multiple::TiB};
 
+    namespace detail {
+        /**
+         * The unit of each multiple, in the order of the multiples' values.
+         */
+        constexpr std::pair<std::string_view, byte_multiple>
+            byte_multiple_units[] = {
+                {"B", byte_multiple::B},
+                {"KiB", byte_multiple::KiB},
+                {"MiB", byte_multiple::MiB},
+                {"GiB", byte_multiple::GiB},
+                {"TiB", byte_multiple::TiB},
+            };
+
+        static_assert([] {
+            for (auto i = std::size_t(); i < multiples.size(); ++i) {
+                if (byte_multiple_units[i].second != multiples[i]) {
+                    return false;
+                }
+            }
+
+            return std::size(byte_multiple_units) == multiples.size();
+        }());
+
+        constexpr auto byte_multiple_keywords =
+            make_keyword_map(byte_multiple_units);
+
+        constexpr auto byte_multiple_name(byte_multiple multiple)
+            -> std::string_view {
+            const auto index = static_cast<std::size_t>(multiple);
+
+            if (index >= std::size(byte_multiple_units)) {
+                throw std::out_of_range("unknown byte multiple");
+            }
+
+            return byte_multiple_units[index].first;
+        }
+    }
+
+    /**
+     * Returns the multiple named by a unit such as "MiB", or nothing if the
+     * name is not recognized.
+     */
+    constexpr auto parse_byte_multiple(std::string_view unit)
+        -> std::optional<byte_multiple> {
+        return detail::byte_multiple_keywords.find(unit);
+    }
+
     auto operator<<(std::ostream& os, byte_multiple multiple) -> std::ostream&;
 
     class data_size {
@@ -69,6 +123,10 @@ namespace ext {
             value(value),
             multiple(multiple) {}
 
+        /**
+         * Equivalent to formatting the size with the spec
+         * '.{decimal_places}'.
+         */
         auto str(uint decimal_places) const -> std::string;
     };
 
@@ -114,3 +172,60 @@ namespace ext {
         }
     }
 }
+
+template <>
+struct fmt::formatter<ext::byte_multiple> : formatter<std::string_view> {
+    auto format(ext::byte_multiple multiple, format_context& ctx) const
+        -> decltype(ctx.out()) {
+        return formatter<std::string_view>::format(
+            ext::detail::byte_multiple_name(multiple),
+            ctx
+        );
+    }
+};
+
+/**
+ * Formats a data size as a value followed by its unit, for example
+ * "1.5 MiB".
+ *
+ * The format spec is '[.precision][unit]'. The value is rounded up to
+ * 'precision' decimal places (2 by default) and trailing zeros are dropped.
+ * If a unit such as 'KiB' is given, the size is expressed in that unit
+ * rather than the largest unit less than the size.
+ */
+template <>
+struct fmt::formatter<ext::data_size> {
+    int precision = 2;
+    std::optional<ext::byte_multiple> unit;
+
+    constexpr auto parse(format_parse_context& ctx) -> decltype(ctx.begin()) {
+        auto* it = ctx.begin();
+        auto* const end = ctx.end();
+
+        if (it != end && *it == '.') {
+            ++it;
+
+            if (it == end || *it < '0' || *it > '9') {
+                throw format_error("expected precision after '.'");
+            }
+
+            precision = 0;
+            while (it != end && *it >= '0' && *it <= '9') {
+                precision = precision * 10 + (*it++ - '0');
+            }
+        }
+
+        const auto* spec_end = it;
+        while (spec_end != end && *spec_end != '}') ++spec_end;
+
+        if (spec_end != it) {
+            unit = ext::parse_byte_multiple({it, spec_end});
+            if (!unit) throw format_error("invalid data size unit");
+        }
+
+        return spec_end;
+    }
+
+    auto format(const ext::data_size& size, format_context& ctx) const
+        -> decltype(ctx.out());
+};
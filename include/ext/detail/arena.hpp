@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace ext {
+    /**
+     * A region of memory that hands out allocations by bumping a pointer
+     * through fixed-size blocks. Individual allocations are never freed; all
+     * memory is released at once when the arena is cleared or destroyed.
+     */
+    class arena final {
+        struct block {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t size;
+        };
+
+        std::vector<block> blocks;
+        std::byte* cursor = nullptr;
+        std::byte* limit = nullptr;
+        std::size_t block_size;
+        std::size_t used = 0;
+
+        auto allocate_block(std::size_t size) -> std::byte*;
+    public:
+        static constexpr std::size_t default_block_size = 4096;
+
+        explicit arena(std::size_t block_size = default_block_size) noexcept;
+
+        arena(const arena&) = delete;
+
+        arena(arena&& other) noexcept;
+
+        auto operator=(const arena&) -> arena& = delete;
+
+        auto operator=(arena&& other) noexcept -> arena&;
+
+        /**
+         * Returns uninitialized memory of the given size and alignment that
+         * remains valid for the lifetime of the arena.
+         */
+        auto allocate(
+            std::size_t size,
+            std::size_t alignment = alignof(std::max_align_t)
+        ) -> void*;
+
+        /**
+         * Releases all memory held by the arena.
+         */
+        auto clear() noexcept -> void;
+
+        /**
+         * Copies the given string into the arena followed by a null
+         * terminator, and returns a view of the copy.
+         */
+        auto copy(std::string_view string) -> std::string_view;
+
+        /**
+         * Returns the number of bytes handed out by the arena.
+         */
+        auto size() const noexcept -> std::size_t;
+    };
+}
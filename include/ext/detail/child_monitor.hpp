@@ -0,0 +1,106 @@
+#pragma once
+
+#include "event_loop.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <sys/types.h>
+
+namespace ext {
+    /**
+     * Suspends coroutines until child processes terminate.
+     *
+     * Each waiting coroutine holds a pidfd for its child, registered with an
+     * event loop, so any number of children can be supervised from one
+     * thread without blocking in waitpid or handling SIGCHLD. The monitor
+     * does not reap children: a resumed coroutine collects the exit status
+     * itself, which no longer blocks.
+     *
+     * A monitor either owns its event loop or shares one with other
+     * coroutines. Like the loop, it is not thread-safe.
+     */
+    class child_monitor final {
+        std::unique_ptr<event_loop> owned;
+        event_loop& loop;
+        std::size_t waiting = 0;
+    public:
+        class awaiter final {
+            /**
+             * Removes the pidfd from the loop before closing it, once the
+             * loop no longer waits for it.
+             */
+            struct pidfd_watch {
+                event_loop& loop;
+                int fd;
+
+                pidfd_watch(event_loop& loop, pid_t pid);
+
+                pidfd_watch(const pidfd_watch&) = delete;
+
+                ~pidfd_watch();
+
+                auto operator=(const pidfd_watch&) -> pidfd_watch& = delete;
+            };
+
+            child_monitor& monitor;
+            pidfd_watch pidfd;
+            event_loop::io_awaiter exit;
+            bool registered = false;
+
+            friend class child_monitor;
+        public:
+            awaiter(child_monitor& monitor, pid_t pid);
+
+            ~awaiter();
+
+            auto await_ready() const noexcept -> bool { return false; }
+
+            auto await_suspend(std::coroutine_handle<> coroutine) -> void;
+
+            auto await_resume() noexcept -> void;
+        };
+
+        /**
+         * Creates a monitor with its own event loop.
+         */
+        child_monitor();
+
+        /**
+         * Creates a monitor that waits for children on 'loop'.
+         */
+        explicit child_monitor(event_loop& loop);
+
+        child_monitor(const child_monitor&) = delete;
+
+        auto operator=(const child_monitor&) -> child_monitor& = delete;
+
+        /**
+         * Returns true if no coroutine is waiting for a child.
+         */
+        auto empty() const noexcept -> bool;
+
+        /**
+         * Returns an awaitable that completes once the child process with
+         * the given ID has terminated. The process must be a child of the
+         * calling process that has not been reaped.
+         */
+        auto exited(pid_t pid) -> awaiter;
+
+        /**
+         * Runs one pass of the event loop, waiting up to 'timeout' for
+         * children to terminate. A negative timeout waits indefinitely.
+         * Returns the number of coroutines resumed, which includes other
+         * coroutines ready on a shared loop.
+         */
+        auto poll(
+            std::chrono::milliseconds timeout = std::chrono::milliseconds(-1)
+        ) -> std::size_t;
+
+        /**
+         * Runs the event loop until no coroutine is waiting for a child.
+         */
+        auto run() -> void;
+    };
+}
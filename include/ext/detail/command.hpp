@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../unix.h"
+#include "arena.hpp"
+
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace ext {
+    /**
+     * A program invocation prepared once and spawned any number of times.
+     *
+     * The argument and environment arrays are built when the command is
+     * created and stored in an arena, so spawning only has to fill in the
+     * arguments marked as slots. Spawning does not modify the command, so
+     * one command may be spawned from several threads at once.
+     */
+    class command final {
+    public:
+        /**
+         * Marks an argument whose value is supplied when the command is
+         * spawned.
+         */
+        struct slot_type {};
+
+        static constexpr auto slot = slot_type();
+
+        using argument = std::variant<std::string_view, slot_type>;
+    private:
+        arena storage;
+        std::vector<char*> argv;
+        std::vector<char*> envp;
+        std::vector<std::size_t> slot_indices;
+        spawn_options options;
+
+        auto store(std::string_view string) -> char*;
+    public:
+        /**
+         * Prepares 'program' with the given arguments. The environment in
+         * 'options' is converted once; the remaining options are applied
+         * each time the command is spawned.
+         */
+        command(
+            std::string_view program,
+            std::span<const argument> args,
+            spawn_options options = {}
+        );
+
+        command(
+            std::string_view program,
+            std::initializer_list<argument> args,
+            spawn_options options = {}
+        );
+
+        /**
+         * Waits for a process started with the given slot values.
+         */
+        auto run(std::span<const std::string_view> values = {}) const
+            -> exit_status;
+
+        /**
+         * The number of arguments that must be supplied when spawning.
+         */
+        auto slots() const noexcept -> std::size_t;
+
+        /**
+         * Starts a process, substituting 'values' for the slots in order.
+         * Throws std::invalid_argument if the number of values does not
+         * match the number of slots.
+         */
+        auto spawn(std::span<const std::string_view> values = {}) const
+            -> process;
+    };
+}
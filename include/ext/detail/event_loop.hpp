@@ -0,0 +1,270 @@
+#pragma once
+
+#include "coroutine/jtask.hpp"
+#include "coroutine/task.hpp"
+#include "flat_hash_map.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <utility>
+#include <vector>
+
+namespace ext {
+    struct event_loop_options {
+        /**
+         * Register descriptors once, edge-triggered, for both directions.
+         *
+         * This saves an epoll_ctl call per wait, but a coroutine is only
+         * resumed by a change in readiness: it must not wait for a
+         * descriptor until an operation on it has failed with EAGAIN, and
+         * descriptors must be removed with 'remove' before they are closed.
+         */
+        bool edge_triggered = false;
+
+        /**
+         * The maximum number of events retrieved by one epoll_wait call.
+         */
+        int max_events = 64;
+    };
+
+    /**
+     * A single-threaded executor for coroutines that wait for file
+     * descriptors and timers, built on epoll.
+     *
+     * Coroutines that become ready are appended to a queue and resumed by
+     * the loop itself, never from within another coroutine, so long chains
+     * of wakeups do not grow the stack. Coroutines resumed in one pass that
+     * schedule themselves again run in the next pass, after the loop has
+     * checked for new events.
+     *
+     * At most one coroutine may wait for each direction of a descriptor at
+     * a time. An event loop is not thread-safe.
+     */
+    class event_loop final {
+        class ready_queue;
+
+        /**
+         * An awaiter that can be queued to resume its coroutine. It leaves
+         * the queue when it is destroyed, so a coroutine that destroys
+         * another coroutine waiting in the same batch does not leave a
+         * dangling handle behind.
+         */
+        class ready_node {
+            friend class event_loop;
+
+            ready_queue* queue = nullptr;
+            ready_node* prev = nullptr;
+            ready_node* next = nullptr;
+        protected:
+            std::coroutine_handle<> coroutine;
+
+            ready_node() = default;
+
+            ~ready_node();
+        public:
+            ready_node(const ready_node&) = delete;
+
+            auto operator=(const ready_node&) -> ready_node& = delete;
+        };
+
+        class ready_queue {
+            ready_node* head = nullptr;
+            ready_node* tail = nullptr;
+        public:
+            auto empty() const noexcept -> bool { return head == nullptr; }
+
+            auto pop() noexcept -> ready_node*;
+
+            auto push(ready_node& node) noexcept -> void;
+
+            auto remove(ready_node& node) noexcept -> void;
+
+            /**
+             * Moves every node in 'other' to the end of this queue.
+             */
+            auto splice(ready_queue& other) noexcept -> void;
+        };
+    public:
+        using clock = std::chrono::steady_clock;
+
+        class io_awaiter final : ready_node {
+            event_loop& loop;
+            int fd;
+            bool write;
+            bool registered = false;
+
+            friend class event_loop;
+
+            io_awaiter(event_loop& loop, int fd, bool write) noexcept;
+        public:
+            ~io_awaiter();
+
+            auto await_ready() const noexcept -> bool { return false; }
+
+            auto await_suspend(std::coroutine_handle<> coroutine) -> void;
+
+            auto await_resume() const noexcept -> void {}
+        };
+
+        class timer_awaiter final : ready_node {
+            using timer_map = std::multimap<clock::time_point, timer_awaiter*>;
+
+            event_loop& loop;
+            clock::time_point deadline;
+            timer_map::iterator timer;
+            bool registered = false;
+
+            friend class event_loop;
+
+            timer_awaiter(
+                event_loop& loop,
+                clock::time_point deadline
+            ) noexcept;
+        public:
+            ~timer_awaiter();
+
+            auto await_ready() const noexcept -> bool;
+
+            auto await_suspend(std::coroutine_handle<> coroutine) -> void;
+
+            auto await_resume() const noexcept -> void {}
+        };
+
+        class schedule_awaiter final : ready_node {
+            event_loop& loop;
+
+            friend class event_loop;
+
+            explicit schedule_awaiter(event_loop& loop) noexcept :
+                loop(loop) {}
+        public:
+            auto await_ready() const noexcept -> bool { return false; }
+
+            auto await_suspend(std::coroutine_handle<> coroutine) noexcept
+                -> void {
+                this->coroutine = coroutine;
+                loop.ready.push(*this);
+            }
+
+            auto await_resume() const noexcept -> void {}
+        };
+    private:
+        struct watch {
+            io_awaiter* reader = nullptr;
+            io_awaiter* writer = nullptr;
+
+            /**
+             * The events the descriptor is registered for; zero if it is
+             * not registered.
+             */
+            std::uint32_t events = 0;
+        };
+
+        int epoll;
+        event_loop_options options;
+        std::vector<epoll_event> events;
+        flat_hash_map<int, watch> watches;
+        timer_awaiter::timer_map timers;
+        ready_queue ready;
+        ready_queue batch;
+        std::size_t waiting = 0;
+
+        auto add(io_awaiter& awaiter) -> void;
+
+        auto remove(io_awaiter& awaiter) noexcept -> void;
+
+        auto update(int fd, watch& w) -> void;
+
+        auto wait(std::chrono::milliseconds timeout) -> void;
+
+        template <typename T>
+        static auto drive(task<T> task) -> jtask<T> {
+            co_return co_await std::move(task);
+        }
+    public:
+        explicit event_loop(event_loop_options options = {});
+
+        event_loop(const event_loop&) = delete;
+
+        ~event_loop();
+
+        auto operator=(const event_loop&) -> event_loop& = delete;
+
+        /**
+         * Returns true if no coroutine is waiting or ready to run.
+         */
+        auto empty() const noexcept -> bool;
+
+        /**
+         * Returns an awaitable that completes once 'fd' is readable, or has
+         * an error or hang-up pending.
+         */
+        auto readable(int fd) noexcept -> io_awaiter;
+
+        /**
+         * Forgets a descriptor that no coroutine is waiting for. Call this
+         * before closing a descriptor in edge-triggered mode.
+         */
+        auto remove(int fd) -> void;
+
+        /**
+         * Resumes coroutines as they become ready until none is waiting or
+         * ready to run.
+         */
+        auto run() -> void;
+
+        /**
+         * Waits up to 'timeout' for events, then resumes every coroutine
+         * that is ready. A negative timeout waits indefinitely; the loop
+         * does not wait if a coroutine is already ready. Returns the number
+         * of coroutines resumed.
+         */
+        auto run_once(
+            std::chrono::milliseconds timeout = std::chrono::milliseconds(-1)
+        ) -> std::size_t;
+
+        /**
+         * Starts 'task' and runs the loop until it completes, returning its
+         * result. Throws std::logic_error if the loop runs out of work
+         * before the task completes.
+         */
+        template <typename T>
+        auto run_until(task<T> target) -> T {
+            auto job = drive(std::move(target));
+
+            while (!job.is_ready()) {
+                if (empty()) {
+                    throw std::logic_error(
+                        "event loop has no work but the task is incomplete"
+                    );
+                }
+
+                run_once();
+            }
+
+            return std::move(job).result();
+        }
+
+        /**
+         * Returns an awaitable that reschedules the awaiting coroutine at
+         * the end of the ready queue.
+         */
+        auto schedule() noexcept -> schedule_awaiter;
+
+        auto sleep_for(clock::duration duration) noexcept -> timer_awaiter;
+
+        auto sleep_until(clock::time_point deadline) noexcept
+            -> timer_awaiter;
+
+        /**
+         * Returns an awaitable that completes once 'fd' is writable, or has
+         * an error or hang-up pending.
+         */
+        auto writable(int fd) noexcept -> io_awaiter;
+    };
+}
@@ -0,0 +1,598 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace ext {
+    namespace detail {
+        template <typename Hash, typename KeyEqual>
+        concept transparent_lookup = requires {
+            typename Hash::is_transparent;
+            typename KeyEqual::is_transparent;
+        };
+    }
+
+    /**
+     * An unordered associative container that stores its elements inline in
+     * a single array using open addressing with linear probing.
+     *
+     * Each slot has a one-byte control entry holding seven bits of the
+     * element's hash, so most probes that do not match are rejected without
+     * comparing keys. If both the hash and the key equality are transparent,
+     * lookups accept any type those accept; in particular, a map keyed by
+     * std::string can be searched with a std::string_view without allocating.
+     *
+     * Unlike std::unordered_map, inserting elements may move the elements
+     * already in the map: insertions invalidate iterators, pointers and
+     * references. Erasing an element invalidates only that element.
+     */
+    template <
+        typename Key,
+        typename T,
+        typename Hash = std::hash<Key>,
+        typename KeyEqual = std::equal_to<Key>>
+    class flat_hash_map final {
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<const Key, T>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+    private:
+        using control_type = std::uint8_t;
+
+        static constexpr control_type empty_slot = 0x00;
+        static constexpr control_type deleted_slot = 0x01;
+        static constexpr control_type occupied = 0x80;
+
+        static constexpr size_type min_capacity = 8;
+        static constexpr size_type npos = -1;
+
+        static constexpr auto transparent =
+            detail::transparent_lookup<Hash, KeyEqual>;
+
+        template <bool Const>
+        class basic_iterator {
+            friend class flat_hash_map;
+
+            template <bool>
+            friend class basic_iterator;
+
+            using map_type =
+                std::conditional_t<Const, const flat_hash_map, flat_hash_map>;
+
+            map_type* map = nullptr;
+            size_type index = 0;
+
+            basic_iterator(map_type* map, size_type index) noexcept :
+                map(map),
+                index(index) {}
+
+            auto skip() noexcept -> void {
+                while (index < map->cap &&
+                       !(map->control[index] & occupied))
+                    ++index;
+            }
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = flat_hash_map::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer =
+                std::conditional_t<Const, const value_type*, value_type*>;
+            using reference =
+                std::conditional_t<Const, const value_type&, value_type&>;
+
+            basic_iterator() noexcept = default;
+
+            template <bool OtherConst>
+            requires(Const && !OtherConst)
+            basic_iterator(const basic_iterator<OtherConst>& other) noexcept :
+                map(other.map),
+                index(other.index) {}
+
+            auto operator*() const noexcept -> reference {
+                return map->slots[index];
+            }
+
+            auto operator->() const noexcept -> pointer {
+                return map->slots + index;
+            }
+
+            auto operator++() noexcept -> basic_iterator& {
+                ++index;
+                skip();
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> basic_iterator {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            auto operator==(const basic_iterator& other) const noexcept
+                -> bool {
+                return index == other.index;
+            }
+        };
+    public:
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+    private:
+        [[no_unique_address]] Hash hash;
+        [[no_unique_address]] KeyEqual equal;
+        std::unique_ptr<control_type[]> control;
+        value_type* slots = nullptr;
+        size_type cap = 0;
+        size_type items = 0;
+        size_type tombstones = 0;
+        unsigned int shift = 0;
+
+        struct probe {
+            size_type index;
+            control_type tag;
+        };
+
+        static constexpr auto capacity_for(size_type count) noexcept
+            -> size_type {
+            // Keep the table at most three quarters full.
+            return std::max(min_capacity, std::bit_ceil(count + count / 3 + 1));
+        }
+
+        template <typename K>
+        auto start(const K& key) const noexcept -> probe {
+            // Fibonacci hashing spreads weak hashes (such as the identity
+            // hash of integers) over the high bits used for the index.
+            const auto mixed = static_cast<std::uint64_t>(hash(key)) *
+                               0x9e3779b97f4a7c15ull;
+
+            return {
+                .index = static_cast<size_type>(mixed >> shift),
+                .tag = static_cast<control_type>(occupied | (mixed & 0x7f))};
+        }
+
+        auto next(size_type index) const noexcept -> size_type {
+            return (index + 1) & (cap - 1);
+        }
+
+        template <typename K>
+        auto find_index(const K& key) const -> size_type {
+            if (items == 0) return npos;
+
+            auto [index, tag] = start(key);
+
+            while (true) {
+                const auto c = control[index];
+
+                if (c == empty_slot) return npos;
+                if (c == tag && equal(slots[index].first, key)) return index;
+
+                index = next(index);
+            }
+        }
+
+        auto allocate(size_type capacity) -> void {
+            control = std::make_unique<control_type[]>(capacity);
+            slots = std::allocator<value_type>().allocate(capacity);
+            cap = capacity;
+            shift = 64 - std::countr_zero(capacity);
+        }
+
+        auto deallocate() noexcept -> void {
+            if (!slots) return;
+
+            for (auto i = 0ul; i < cap; ++i) {
+                if (control[i] & occupied) std::destroy_at(slots + i);
+            }
+
+            std::allocator<value_type>().deallocate(slots, cap);
+
+            control.reset();
+            slots = nullptr;
+            cap = 0;
+            items = 0;
+            tombstones = 0;
+        }
+
+        auto rehash_to(size_type capacity) -> void {
+            auto old_control = std::move(control);
+            auto* const old_slots = slots;
+            const auto old_cap = cap;
+
+            allocate(capacity);
+            tombstones = 0;
+
+            for (auto i = 0ul; i < old_cap; ++i) {
+                if (!(old_control[i] & occupied)) continue;
+
+                auto& old = old_slots[i];
+                auto [index, tag] = start(old.first);
+
+                while (control[index] != empty_slot) index = next(index);
+
+                // Keys are const only to protect them from callers; the old
+                // element is destroyed immediately after being moved from.
+                std::construct_at(
+                    slots + index,
+                    std::move(const_cast<Key&>(old.first)),
+                    std::move(old.second)
+                );
+                control[index] = tag;
+
+                std::destroy_at(&old);
+            }
+
+            if (old_slots) {
+                std::allocator<value_type>().deallocate(old_slots, old_cap);
+            }
+        }
+
+        auto grow() -> void {
+            const auto needed = capacity_for(items + 1);
+
+            // A table filled mostly with tombstones only needs cleaning.
+            if (needed <= cap) rehash_to(cap);
+            else rehash_to(std::max(needed, cap * 2));
+        }
+
+        template <typename K, typename... Args>
+        auto emplace_key(K&& key, Args&&... args) -> std::pair<iterator, bool> {
+            if (const auto found = find_index(key); found != npos) {
+                return {iterator(this, found), false};
+            }
+
+            if (capacity_for(items + tombstones + 1) > cap) grow();
+
+            auto [index, tag] = start(key);
+
+            while (control[index] & occupied) index = next(index);
+
+            std::construct_at(
+                slots + index,
+                std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...)
+            );
+
+            if (control[index] == deleted_slot) --tombstones;
+            control[index] = tag;
+            ++items;
+
+            return {iterator(this, index), true};
+        }
+
+        template <typename K, typename M>
+        auto assign_key(K&& key, M&& obj) -> std::pair<iterator, bool> {
+            if (const auto found = find_index(key); found != npos) {
+                slots[found].second = std::forward<M>(obj);
+                return {iterator(this, found), false};
+            }
+
+            return emplace_key(std::forward<K>(key), std::forward<M>(obj));
+        }
+
+        auto erase_index(size_type index) noexcept -> void {
+            std::destroy_at(slots + index);
+            --items;
+
+            // Probe sequences stop at empty slots, so a slot followed by an
+            // empty one can be emptied without breaking any sequence.
+            if (control[next(index)] == empty_slot) control[index] = empty_slot;
+            else {
+                control[index] = deleted_slot;
+                ++tombstones;
+            }
+        }
+    public:
+        flat_hash_map() noexcept(
+            noexcept(Hash()) && noexcept(KeyEqual())
+        ) = default;
+
+        explicit flat_hash_map(
+            size_type capacity,
+            const Hash& hash = Hash(),
+            const KeyEqual& equal = KeyEqual()
+        ) :
+            hash(hash),
+            equal(equal) {
+            reserve(capacity);
+        }
+
+        flat_hash_map(std::initializer_list<value_type> init) {
+            reserve(init.size());
+            for (const auto& value : init) insert(value);
+        }
+
+        flat_hash_map(const flat_hash_map& other) :
+            hash(other.hash),
+            equal(other.equal) {
+            if (other.cap == 0) return;
+
+            allocate(other.cap);
+
+            for (auto i = 0ul; i < cap; ++i) {
+                if (other.control[i] & occupied) {
+                    std::construct_at(slots + i, other.slots[i]);
+                    control[i] = other.control[i];
+                    ++items;
+                }
+                else if (other.control[i] == deleted_slot) {
+                    control[i] = deleted_slot;
+                    ++tombstones;
+                }
+            }
+        }
+
+        flat_hash_map(flat_hash_map&& other) noexcept :
+            hash(std::move(other.hash)),
+            equal(std::move(other.equal)),
+            control(std::move(other.control)),
+            slots(std::exchange(other.slots, nullptr)),
+            cap(std::exchange(other.cap, 0)),
+            items(std::exchange(other.items, 0)),
+            tombstones(std::exchange(other.tombstones, 0)),
+            shift(std::exchange(other.shift, 0)) {}
+
+        ~flat_hash_map() { deallocate(); }
+
+        auto operator=(const flat_hash_map& other) -> flat_hash_map& {
+            if (std::addressof(other) != this) {
+                auto copy = other;
+                swap(copy);
+            }
+
+            return *this;
+        }
+
+        auto operator=(flat_hash_map&& other) noexcept -> flat_hash_map& {
+            if (std::addressof(other) != this) {
+                deallocate();
+                std::destroy_at(this);
+                std::construct_at(this, std::move(other));
+            }
+
+            return *this;
+        }
+
+        auto operator[](const Key& key) -> T& {
+            return emplace_key(key).first->second;
+        }
+
+        auto operator[](Key&& key) -> T& {
+            return emplace_key(std::move(key)).first->second;
+        }
+
+        template <typename K>
+        requires transparent
+        auto operator[](K&& key) -> T& {
+            return emplace_key(std::forward<K>(key)).first->second;
+        }
+
+        auto at(const Key& key) -> T& { return at<Key>(key); }
+
+        auto at(const Key& key) const -> const T& { return at<Key>(key); }
+
+        template <typename K>
+        requires transparent || std::same_as<K, Key>
+        auto at(const K& key) -> T& {
+            const auto index = find_index(key);
+            if (index == npos) throw std::out_of_range("key not found");
+            return slots[index].second;
+        }
+
+        template <typename K>
+        requires transparent || std::same_as<K, Key>
+        auto at(const K& key) const -> const T& {
+            const auto index = find_index(key);
+            if (index == npos) throw std::out_of_range("key not found");
+            return slots[index].second;
+        }
+
+        auto begin() noexcept -> iterator {
+            auto it = iterator(this, 0);
+            if (cap) it.skip();
+            return it;
+        }
+
+        auto begin() const noexcept -> const_iterator {
+            auto it = const_iterator(this, 0);
+            if (cap) it.skip();
+            return it;
+        }
+
+        auto cbegin() const noexcept -> const_iterator { return begin(); }
+
+        auto end() noexcept -> iterator { return iterator(this, cap); }
+
+        auto end() const noexcept -> const_iterator {
+            return const_iterator(this, cap);
+        }
+
+        auto cend() const noexcept -> const_iterator { return end(); }
+
+        auto capacity() const noexcept -> size_type { return cap; }
+
+        auto clear() noexcept -> void {
+            for (auto i = 0ul; i < cap; ++i) {
+                if (control[i] & occupied) std::destroy_at(slots + i);
+            }
+
+            if (cap) std::memset(control.get(), empty_slot, cap);
+
+            items = 0;
+            tombstones = 0;
+        }
+
+        auto contains(const Key& key) const -> bool {
+            return find_index(key) != npos;
+        }
+
+        template <typename K>
+        requires transparent
+        auto contains(const K& key) const -> bool {
+            return find_index(key) != npos;
+        }
+
+        auto count(const Key& key) const -> size_type {
+            return contains(key) ? 1 : 0;
+        }
+
+        template <typename K>
+        requires transparent
+        auto count(const K& key) const -> size_type {
+            return contains(key) ? 1 : 0;
+        }
+
+        template <typename... Args>
+        auto emplace(Args&&... args) -> std::pair<iterator, bool> {
+            auto value = value_type(std::forward<Args>(args)...);
+            return emplace_key(
+                std::move(const_cast<Key&>(value.first)),
+                std::move(value.second)
+            );
+        }
+
+        auto empty() const noexcept -> bool { return items == 0; }
+
+        auto erase(const Key& key) -> size_type { return erase<Key>(key); }
+
+        template <typename K>
+        requires(transparent || std::same_as<K, Key>) &&
+                (!std::convertible_to<K, const_iterator>)
+        auto erase(const K& key) -> size_type {
+            const auto index = find_index(key);
+            if (index == npos) return 0;
+
+            erase_index(index);
+            return 1;
+        }
+
+        auto erase(const_iterator pos) -> iterator {
+            erase_index(pos.index);
+
+            auto it = iterator(this, pos.index);
+            ++it;
+            return it;
+        }
+
+        auto erase(iterator pos) -> iterator {
+            return erase(const_iterator(pos));
+        }
+
+        auto find(const Key& key) -> iterator { return find<Key>(key); }
+
+        auto find(const Key& key) const -> const_iterator {
+            return find<Key>(key);
+        }
+
+        template <typename K>
+        requires transparent || std::same_as<K, Key>
+        auto find(const K& key) -> iterator {
+            const auto index = find_index(key);
+            return index == npos ? end() : iterator(this, index);
+        }
+
+        template <typename K>
+        requires transparent || std::same_as<K, Key>
+        auto find(const K& key) const -> const_iterator {
+            const auto index = find_index(key);
+            return index == npos ? end() : const_iterator(this, index);
+        }
+
+        auto hash_function() const -> hasher { return hash; }
+
+        auto insert(const value_type& value) -> std::pair<iterator, bool> {
+            return emplace_key(value.first, value.second);
+        }
+
+        auto insert(value_type&& value) -> std::pair<iterator, bool> {
+            return emplace_key(
+                std::move(const_cast<Key&>(value.first)),
+                std::move(value.second)
+            );
+        }
+
+        template <typename M>
+        auto insert_or_assign(const Key& key, M&& obj)
+            -> std::pair<iterator, bool> {
+            return assign_key(key, std::forward<M>(obj));
+        }
+
+        template <typename M>
+        auto insert_or_assign(Key&& key, M&& obj) -> std::pair<iterator, bool> {
+            return assign_key(std::move(key), std::forward<M>(obj));
+        }
+
+        template <typename K, typename M>
+        requires transparent
+        auto insert_or_assign(K&& key, M&& obj) -> std::pair<iterator, bool> {
+            return assign_key(std::forward<K>(key), std::forward<M>(obj));
+        }
+
+        auto key_eq() const -> key_equal { return equal; }
+
+        auto load_factor() const noexcept -> float {
+            return cap == 0 ? 0.0f : static_cast<float>(items) / cap;
+        }
+
+        /**
+         * Ensures that 'count' elements can be held without rehashing.
+         */
+        auto reserve(size_type count) -> void {
+            if (count == 0) return;
+
+            const auto needed = capacity_for(count);
+            if (needed > cap) rehash_to(needed);
+        }
+
+        auto size() const noexcept -> size_type { return items; }
+
+        auto swap(flat_hash_map& other) noexcept -> void {
+            using std::swap;
+
+            swap(hash, other.hash);
+            swap(equal, other.equal);
+            swap(control, other.control);
+            swap(slots, other.slots);
+            swap(cap, other.cap);
+            swap(items, other.items);
+            swap(tombstones, other.tombstones);
+            swap(shift, other.shift);
+        }
+
+        template <typename... Args>
+        auto try_emplace(const Key& key, Args&&... args)
+            -> std::pair<iterator, bool> {
+            return emplace_key(key, std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        auto try_emplace(Key&& key, Args&&... args)
+            -> std::pair<iterator, bool> {
+            return emplace_key(std::move(key), std::forward<Args>(args)...);
+        }
+
+        template <typename K, typename... Args>
+        requires transparent
+        auto try_emplace(K&& key, Args&&... args) -> std::pair<iterator, bool> {
+            return emplace_key(
+                std::forward<K>(key),
+                std::forward<Args>(args)...
+            );
+        }
+    };
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace ext {
+    namespace detail {
+        constexpr std::uint64_t wyhash_secret[4] = {
+            0x2d358dccaa6c78a5ull,
+            0x8bb84b93962eacc9ull,
+            0x4b33a62ed433d4a3ull,
+            0x4d5a2da51de1aa47ull};
+
+        inline auto wymum(std::uint64_t& a, std::uint64_t& b) noexcept
+            -> void {
+            const auto r = static_cast<unsigned __int128>(a) * b;
+            a = static_cast<std::uint64_t>(r);
+            b = static_cast<std::uint64_t>(r >> 64);
+        }
+
+        inline auto wymix(std::uint64_t a, std::uint64_t b) noexcept
+            -> std::uint64_t {
+            wymum(a, b);
+            return a ^ b;
+        }
+
+        inline auto read64(const std::uint8_t* p) noexcept -> std::uint64_t {
+            auto value = std::uint64_t();
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline auto read32(const std::uint8_t* p) noexcept -> std::uint64_t {
+            auto value = std::uint32_t();
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+    }
+
+    /**
+     * Computes a fast, non-cryptographic 64-bit hash of a byte sequence
+     * using the wyhash algorithm.
+     *
+     * Hashes depend on the host's endianness and should not be persisted.
+     */
+    inline auto hash_bytes(
+        const void* data,
+        std::size_t size,
+        std::uint64_t seed = 0
+    ) noexcept -> std::uint64_t {
+        using detail::read32;
+        using detail::read64;
+        using detail::wymix;
+        using detail::wymum;
+
+        constexpr const auto& secret = detail::wyhash_secret;
+
+        const auto* p = static_cast<const std::uint8_t*>(data);
+        auto a = std::uint64_t();
+        auto b = std::uint64_t();
+
+        seed ^= wymix(seed ^ secret[0], secret[1]);
+
+        if (size <= 16) {
+            if (size >= 4) {
+                const auto offset = (size >> 3) << 2;
+                a = (read32(p) << 32) | read32(p + offset);
+                b = (read32(p + size - 4) << 32) |
+                    read32(p + size - 4 - offset);
+            }
+            else if (size > 0) {
+                a = (std::uint64_t(p[0]) << 16) |
+                    (std::uint64_t(p[size >> 1]) << 8) | p[size - 1];
+            }
+        }
+        else {
+            auto remaining = size;
+
+            if (remaining > 48) {
+                auto see1 = seed;
+                auto see2 = seed;
+
+                do {
+                    seed = wymix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                    see1 = wymix(
+                        read64(p + 16) ^ secret[2],
+                        read64(p + 24) ^ see1
+                    );
+                    see2 = wymix(
+                        read64(p + 32) ^ secret[3],
+                        read64(p + 40) ^ see2
+                    );
+
+                    p += 48;
+                    remaining -= 48;
+                } while (remaining > 48);
+
+                seed ^= see1 ^ see2;
+            }
+
+            while (remaining > 16) {
+                seed = wymix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                p += 16;
+                remaining -= 16;
+            }
+
+            a = read64(p + remaining - 16);
+            b = read64(p + remaining - 8);
+        }
+
+        a ^= secret[1];
+        b ^= seed;
+        wymum(a, b);
+
+        return wymix(a ^ secret[0] ^ size, b ^ secret[1]);
+    }
+
+    /**
+     * A transparent hash for string types.
+     *
+     * Any type convertible to std::string_view can be hashed, so containers
+     * keyed by std::string can be searched with a view without allocating.
+     */
+    struct string_hash {
+        using is_transparent = void;
+
+        auto operator()(std::string_view string) const noexcept
+            -> std::size_t {
+            return hash_bytes(string.data(), string.size());
+        }
+    };
+}
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "../unix.h"
+#include "flat_hash_map.hpp"
+#include "hash.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+namespace ext {
+    struct identity_cache_options {
+        /**
+         * How long a user or group that was found is reused before it is
+         * looked up again.
+         */
+        std::chrono::steady_clock::duration ttl = std::chrono::minutes(5);
+
+        /**
+         * How long the absence of a user or group is remembered.
+         */
+        std::chrono::steady_clock::duration negative_ttl =
+            std::chrono::seconds(30);
+
+        /**
+         * The maximum number of missing IDs, and separately of missing
+         * names, that are remembered. The oldest are forgotten first.
+         */
+        std::size_t max_missing = 1024;
+    };
+
+    namespace detail {
+        /**
+         * Cached entries of one database, indexed by both ID and name.
+         * A null value records that no entry exists for the key.
+         *
+         * Expired entries are overwritten when their key is looked up again
+         * and swept out whenever the table has doubled in size since the
+         * last sweep. Entries for missing keys are also kept in insertion
+         * order, which is the order in which they expire, so that the
+         * oldest can be evicted once there are too many.
+         */
+        template <typename T, typename Id>
+        class identity_table final {
+        public:
+            using clock = std::chrono::steady_clock;
+            using pointer = std::shared_ptr<const T>;
+        private:
+            static constexpr auto min_sweep = std::size_t(64);
+
+            struct entry {
+                pointer value;
+                clock::time_point expires;
+            };
+
+            template <typename Key>
+            struct missing_entry {
+                Key key;
+                clock::time_point expires;
+            };
+
+            mutable std::shared_mutex mutex;
+            std::size_t max_missing;
+            std::size_t sweep_at = min_sweep;
+
+            flat_hash_map<Id, entry> ids;
+            flat_hash_map<std::string, entry, string_hash, std::equal_to<>>
+                names;
+
+            std::deque<missing_entry<Id>> missing_ids;
+            std::deque<missing_entry<std::string>> missing_names;
+
+            template <typename Map, typename Key>
+            static auto find(
+                const Map& map,
+                const Key& key,
+                clock::time_point now
+            ) -> std::optional<pointer> {
+                const auto it = map.find(key);
+                if (it == map.end() || it->second.expires <= now) return {};
+                return it->second.value;
+            }
+
+            template <typename Map, typename Key>
+            auto insert_missing(
+                Map& map,
+                std::deque<missing_entry<Key>>& queue,
+                Key key,
+                clock::time_point now,
+                clock::time_point expires
+            ) -> void {
+                // Records whose key has since been stored again no longer
+                // match the map, and are dropped without touching it.
+                while (!queue.empty() && (queue.front().expires <= now ||
+                                          queue.size() >= max_missing)) {
+                    const auto& front = queue.front();
+                    const auto it = map.find(front.key);
+
+                    if (it != map.end() && !it->second.value &&
+                        it->second.expires == front.expires) {
+                        map.erase(it);
+                    }
+
+                    queue.pop_front();
+                }
+
+                if (max_missing == 0) return;
+
+                map.insert_or_assign(key, entry {nullptr, expires});
+                queue.push_back({std::move(key), expires});
+            }
+
+            template <typename Map>
+            static auto sweep(Map& map, clock::time_point now) -> void {
+                for (auto it = map.begin(); it != map.end();) {
+                    if (it->second.expires <= now) it = map.erase(it);
+                    else ++it;
+                }
+            }
+        public:
+            explicit identity_table(std::size_t max_missing) :
+                max_missing(max_missing) {}
+
+            auto clear() -> void {
+                const auto lock = std::unique_lock(mutex);
+
+                ids.clear();
+                names.clear();
+                missing_ids.clear();
+                missing_names.clear();
+                sweep_at = min_sweep;
+            }
+
+            auto find(Id id, clock::time_point now) const
+                -> std::optional<pointer> {
+                const auto lock = std::shared_lock(mutex);
+                return find(ids, id, now);
+            }
+
+            auto find(std::string_view name, clock::time_point now) const
+                -> std::optional<pointer> {
+                const auto lock = std::shared_lock(mutex);
+                return find(names, name, now);
+            }
+
+            /**
+             * Returns the number of keys cached, including expired ones.
+             */
+            auto size() const -> std::size_t {
+                const auto lock = std::shared_lock(mutex);
+                return ids.size() + names.size();
+            }
+
+            /**
+             * Records that no entry with the given ID exists.
+             */
+            auto store_missing(
+                Id id,
+                clock::time_point now,
+                clock::time_point expires
+            ) -> void {
+                const auto lock = std::unique_lock(mutex);
+                insert_missing(ids, missing_ids, id, now, expires);
+            }
+
+            /**
+             * Records that no entry with the given name exists.
+             */
+            auto store_missing(
+                std::string_view name,
+                clock::time_point now,
+                clock::time_point expires
+            ) -> void {
+                const auto lock = std::unique_lock(mutex);
+                insert_missing(
+                    names,
+                    missing_names,
+                    std::string(name),
+                    now,
+                    expires
+                );
+            }
+
+            /**
+             * Stores an entry under both its ID and its name.
+             */
+            auto store(
+                Id id,
+                std::string_view name,
+                const pointer& value,
+                clock::time_point now,
+                clock::time_point expires
+            ) -> void {
+                const auto lock = std::unique_lock(mutex);
+
+                ids.insert_or_assign(id, entry {value, expires});
+                names.insert_or_assign(
+                    std::string(name),
+                    entry {value, expires}
+                );
+
+                // Entries stored under a name or ID that is never looked up
+                // again would otherwise stay forever.
+                if (ids.size() + names.size() >= sweep_at) {
+                    sweep(ids, now);
+                    sweep(names, now);
+
+                    sweep_at =
+                        std::max(min_sweep, 2 * (ids.size() + names.size()));
+                }
+            }
+        };
+    }
+
+    /**
+     * Caches user and group database entries by ID and by name.
+     *
+     * Each lookup through 'user' or 'group' queries the system databases,
+     * which may involve NSS modules talking to a directory server. The cache
+     * keeps the results, including the fact that an entry does not exist,
+     * for a configurable time and hands out shared, immutable entries that
+     * are cheap to copy. A lookup by ID also caches the entry by name and
+     * vice versa.
+     *
+     * The cache is safe to use from multiple threads. Lookups that miss are
+     * performed without holding a lock, so concurrent misses for the same key
+     * may query the database more than once.
+     */
+    class identity_cache final {
+        using clock = std::chrono::steady_clock;
+
+        identity_cache_options options;
+        detail::identity_table<ext::group, gid_t> groups;
+        detail::identity_table<ext::user, uid_t> users;
+    public:
+        explicit identity_cache(identity_cache_options options = {});
+
+        /**
+         * Discards all cached entries.
+         */
+        auto clear() -> void;
+
+        /**
+         * Returns the group with the given ID, or null if there is none.
+         * Throws if the group database cannot be read.
+         */
+        auto find_group(gid_t gid) -> std::shared_ptr<const ext::group>;
+
+        /**
+         * Returns the group with the given name, or null if there is none.
+         * Throws if the group database cannot be read.
+         */
+        auto find_group(std::string_view name)
+            -> std::shared_ptr<const ext::group>;
+
+        /**
+         * Returns the user with the given ID, or null if there is none.
+         * Throws if the user database cannot be read.
+         */
+        auto find_user(uid_t uid) -> std::shared_ptr<const ext::user>;
+
+        /**
+         * Returns the user with the given name, or null if there is none.
+         * Throws if the user database cannot be read.
+         */
+        auto find_user(std::string_view name)
+            -> std::shared_ptr<const ext::user>;
+    };
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "arena.hpp"
+#include "flat_hash_map.hpp"
+#include "hash.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+namespace ext {
+    /**
+     * A compact identifier for an interned string. Two symbols from the same
+     * table are equal if and only if their strings are equal.
+     */
+    enum class symbol : std::uint32_t {};
+
+    /**
+     * A table that stores a single copy of each distinct string it is given.
+     *
+     * Strings are copied into an arena, so views returned by the table remain
+     * valid for as long as the table exists. Lookups accept any string view
+     * and never allocate.
+     */
+    class interner final {
+        arena storage;
+        std::vector<std::string_view> strings;
+        flat_hash_map<std::string_view, symbol, string_hash> symbols;
+        std::uint64_t limit = max_symbols;
+    public:
+        /**
+         * The number of distinct symbols.
+         */
+        static constexpr std::uint64_t max_symbols =
+            std::uint64_t(std::numeric_limits<std::uint32_t>::max()) + 1;
+
+        interner() = default;
+
+        /**
+         * Creates a table that holds at most 'max_size' strings, or
+         * 'max_symbols' if that is smaller.
+         */
+        explicit interner(std::uint64_t max_size);
+
+        interner(const interner&) = delete;
+
+        interner(interner&&) = default;
+
+        auto operator=(const interner&) -> interner& = delete;
+
+        auto operator=(interner&&) -> interner& = default;
+
+        /**
+         * Returns the string that the given symbol refers to.
+         */
+        auto operator[](symbol sym) const noexcept -> std::string_view;
+
+        auto contains(std::string_view string) const -> bool;
+
+        /**
+         * Returns the symbol for the given string if it has been interned.
+         */
+        auto find(std::string_view string) const -> std::optional<symbol>;
+
+        /**
+         * Returns the symbol for the given string, adding the string to the
+         * table if it is not already present. Throws std::length_error if
+         * the string is new and the table is full.
+         */
+        auto intern(std::string_view string) -> symbol;
+
+        /**
+         * Returns the table's copy of the given string, adding the string to
+         * the table if it is not already present.
+         */
+        auto intern_view(std::string_view string) -> std::string_view;
+
+        auto max_size() const noexcept -> std::uint64_t;
+
+        auto size() const noexcept -> std::size_t;
+    };
+
+    /**
+     * An interner that may be used from multiple threads at once.
+     *
+     * Strings are distributed across independently locked shards by hash, so
+     * threads interning different strings rarely contend. The shard is
+     * encoded in the low bits of each symbol, so each shard holds at most
+     * 'interner::max_symbols / shard_count()' strings.
+     */
+    class sharded_interner final {
+        struct shard {
+            mutable std::shared_mutex mutex;
+            interner strings;
+        };
+
+        std::unique_ptr<shard[]> shards;
+        unsigned int shard_bits = 0;
+
+        auto shard_for(std::string_view string) const noexcept -> std::size_t;
+    public:
+        static constexpr std::size_t default_shard_count = 16;
+
+        /**
+         * Creates an interner with at least the given number of shards.
+         * The count is rounded up to a power of two, which must leave room
+         * for more than one string per shard.
+         */
+        explicit sharded_interner(
+            std::size_t shard_count = default_shard_count
+        );
+
+        auto operator[](symbol sym) const -> std::string_view;
+
+        auto contains(std::string_view string) const -> bool;
+
+        auto find(std::string_view string) const -> std::optional<symbol>;
+
+        auto intern(std::string_view string) -> symbol;
+
+        auto intern_view(std::string_view string) -> std::string_view;
+
+        auto shard_count() const noexcept -> std::size_t;
+
+        auto size() const -> std::size_t;
+    };
+}
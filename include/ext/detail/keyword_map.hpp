@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace ext {
+    /**
+     * An immutable map from a fixed set of strings to values, built with a
+     * perfect hash so that a lookup costs one hash and one string comparison.
+     *
+     * The map is normally constructed at compile time:
+     *
+     *     constexpr auto colors = ext::make_keyword_map<color>({
+     *         {"red", color::red},
+     *         {"green", color::green},
+     *     });
+     *
+     * Construction uses hash and displace: keys are distributed into
+     * buckets by one hash, and each bucket is assigned the first seed for a
+     * second hash that sends all of its keys to unused slots.
+     */
+    template <typename T, std::size_t N>
+    class keyword_map final {
+    public:
+        using entry = std::pair<std::string_view, T>;
+    private:
+        static constexpr auto table_size = N == 0 ? 1 : std::bit_ceil(N);
+        static constexpr auto mask = table_size - 1;
+        static constexpr auto max_seed = std::uint32_t(1) << 20;
+
+        std::array<entry, N> entries;
+        std::array<std::uint32_t, table_size> seeds = {};
+        std::array<std::size_t, table_size> slots = {};
+
+        static constexpr auto hash(std::string_view key, std::uint64_t seed)
+            -> std::uint64_t {
+            // FNV-1a, with the seed folded into the offset basis and a final
+            // mix so that the low bits depend on every byte.
+            auto h = 0xcbf29ce484222325ull ^ (seed * 0x9e3779b97f4a7c15ull);
+
+            for (const auto c : key) {
+                h ^= static_cast<unsigned char>(c);
+                h *= 0x100000001b3ull;
+            }
+
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+
+            return h;
+        }
+
+        static constexpr auto bucket(std::string_view key) -> std::size_t {
+            return hash(key, 0) & mask;
+        }
+    public:
+        constexpr keyword_map(const entry (&init)[N]) {
+            constexpr auto empty = N;
+
+            for (auto i = 0ul; i < N; ++i) {
+                entries[i] = init[i];
+
+                for (auto j = 0ul; j < i; ++j) {
+                    if (entries[j].first == entries[i].first) {
+                        throw std::invalid_argument("duplicate keyword");
+                    }
+                }
+            }
+
+            slots.fill(empty);
+
+            auto sizes = std::array<std::size_t, table_size>();
+            for (const auto& [key, value] : entries) ++sizes[bucket(key)];
+
+            // Place the largest buckets first, while the table is emptiest.
+            auto order = std::array<std::size_t, table_size>();
+            for (auto i = 0ul; i < table_size; ++i) order[i] = i;
+
+            for (auto i = 1ul; i < table_size; ++i) {
+                auto j = i;
+
+                while (j > 0 && sizes[order[j]] > sizes[order[j - 1]]) {
+                    std::swap(order[j], order[j - 1]);
+                    --j;
+                }
+            }
+
+            for (const auto b : order) {
+                if (sizes[b] == 0) break;
+
+                auto members = std::array<std::size_t, N>();
+                auto count = 0ul;
+
+                for (auto i = 0ul; i < N; ++i) {
+                    if (bucket(entries[i].first) == b) members[count++] = i;
+                }
+
+                auto seed = std::uint32_t(1);
+
+                for (; seed < max_seed; ++seed) {
+                    auto targets = std::array<std::size_t, N>();
+                    auto placed = true;
+
+                    for (auto i = 0ul; i < count && placed; ++i) {
+                        const auto slot =
+                            hash(entries[members[i]].first, seed) & mask;
+                        placed = slots[slot] == empty;
+
+                        for (auto j = 0ul; j < i && placed; ++j) {
+                            placed = targets[j] != slot;
+                        }
+
+                        targets[i] = slot;
+                    }
+
+                    if (!placed) continue;
+
+                    for (auto i = 0ul; i < count; ++i) {
+                        slots[targets[i]] = members[i];
+                    }
+
+                    seeds[b] = seed;
+                    break;
+                }
+
+                if (seed == max_seed) {
+                    throw std::logic_error("failed to build keyword map");
+                }
+            }
+        }
+
+        constexpr auto contains(std::string_view key) const noexcept -> bool {
+            return find_index(key) != N;
+        }
+
+        /**
+         * Returns the value associated with 'key', or nothing if the key is
+         * not in the map.
+         */
+        constexpr auto find(std::string_view key) const -> std::optional<T> {
+            const auto index = find_index(key);
+            if (index == N) return std::nullopt;
+            return entries[index].second;
+        }
+
+        constexpr auto size() const noexcept -> std::size_t { return N; }
+
+        constexpr auto begin() const noexcept { return entries.begin(); }
+
+        constexpr auto end() const noexcept { return entries.end(); }
+    private:
+        constexpr auto find_index(std::string_view key) const noexcept
+            -> std::size_t {
+            if constexpr (N == 0) return N;
+            else {
+                const auto seed = seeds[bucket(key)];
+                if (seed == 0) return N;
+
+                const auto index = slots[hash(key, seed) & mask];
+                if (index == N || entries[index].first != key) return N;
+
+                return index;
+            }
+        }
+    };
+
+    template <typename T, std::size_t N>
+    constexpr auto make_keyword_map(
+        const std::pair<std::string_view, T> (&entries)[N]
+    ) -> keyword_map<T, N> {
+        return keyword_map<T, N>(entries);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <fmt/format.h>
+
+namespace ext::detail {
+    /**
+     * A base for fmt formatters of types that accept no format spec.
+     */
+    struct no_spec_formatter {
+        constexpr auto parse(fmt::format_parse_context& ctx)
+            -> decltype(ctx.begin()) {
+            auto* const it = ctx.begin();
+
+            if (it != ctx.end() && *it != '}') {
+                throw fmt::format_error("invalid format");
+            }
+
+            return it;
+        }
+    };
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "dynarray.hpp"
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+
+namespace ext {
+    template <typename T>
+    concept parsable = std::integral<T> || std::floating_point<T> ||
+                       std::same_as<T, std::string_view> ||
+                       std::same_as<T, std::string>;
+
+    /**
+     * Holds either a parsed value or the reason parsing failed.
+     */
+    template <typename T>
+    class parse_result final {
+        std::optional<T> val;
+        std::errc ec = std::errc();
+    public:
+        using value_type = T;
+
+        parse_result(T value) : val(std::move(value)) {}
+
+        parse_result(std::errc error) noexcept : ec(error) {}
+
+        explicit operator bool() const noexcept { return has_value(); }
+
+        auto operator*() & noexcept -> T& { return *val; }
+
+        auto operator*() const& noexcept -> const T& { return *val; }
+
+        auto operator*() && noexcept -> T&& { return *std::move(val); }
+
+        auto operator->() noexcept -> T* { return val.operator->(); }
+
+        auto operator->() const noexcept -> const T* {
+            return val.operator->();
+        }
+
+        /**
+         * Returns 'std::errc()' if parsing succeeded.
+         */
+        auto error() const noexcept -> std::errc { return ec; }
+
+        auto has_value() const noexcept -> bool { return val.has_value(); }
+
+        auto value() & -> T& {
+            check();
+            return *val;
+        }
+
+        auto value() const& -> const T& {
+            check();
+            return *val;
+        }
+
+        auto value() && -> T&& {
+            check();
+            return *std::move(val);
+        }
+
+        template <typename U>
+        auto value_or(U&& default_value) const& -> T {
+            return val.value_or(std::forward<U>(default_value));
+        }
+
+        template <typename U>
+        auto value_or(U&& default_value) && -> T {
+            return std::move(val).value_or(std::forward<U>(default_value));
+        }
+    private:
+        auto check() const -> void {
+            if (!val) {
+                throw std::system_error(
+                    std::make_error_code(ec),
+                    "failed to parse value"
+                );
+            }
+        }
+    };
+
+    namespace detail {
+        template <parsable T>
+        auto parse_into(std::string_view field, T& value) -> std::errc {
+            if constexpr (std::same_as<T, bool>) {
+                if (field == "1" || field == "true") value = true;
+                else if (field == "0" || field == "false") value = false;
+                else return std::errc::invalid_argument;
+
+                return std::errc();
+            }
+            else if constexpr (std::same_as<T, std::string_view>) {
+                value = field;
+                return std::errc();
+            }
+            else if constexpr (std::same_as<T, std::string>) {
+                value.assign(field);
+                return std::errc();
+            }
+            else {
+                const auto* const end = field.data() + field.size();
+                const auto [ptr, ec] =
+                    std::from_chars(field.data(), end, value);
+
+                if (ec != std::errc()) return ec;
+
+                // The whole field must be consumed.
+                if (ptr != end) return std::errc::invalid_argument;
+
+                return std::errc();
+            }
+        }
+
+        /**
+         * Splits 'line' into exactly 'fields.size()' fields.
+         */
+        inline auto split_fields(
+            std::string_view line,
+            std::string_view delimiter,
+            std::span<std::string_view> fields
+        ) noexcept -> bool {
+            if (fields.empty()) return line.empty();
+
+            auto first = std::string_view::size_type();
+
+            for (auto i = 0ul; i < fields.size() - 1; ++i) {
+                const auto last = line.find(delimiter, first);
+                if (last == std::string_view::npos) return false;
+
+                fields[i] = line.substr(first, last - first);
+                first = last + delimiter.size();
+            }
+
+            const auto rest = line.substr(first);
+            if (rest.find(delimiter) != std::string_view::npos) return false;
+
+            fields.back() = rest;
+            return true;
+        }
+
+        template <parsable... Ts>
+        auto parse_fields(
+            std::string_view line,
+            std::string_view delimiter,
+            std::tuple<Ts...>& values
+        ) -> std::errc {
+            auto fields = std::array<std::string_view, sizeof...(Ts)>();
+            if (!split_fields(line, delimiter, fields)) {
+                return std::errc::invalid_argument;
+            }
+
+            auto ec = std::errc();
+
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (... &&
+                 ((ec = parse_into(fields[I], std::get<I>(values))) ==
+                  std::errc()));
+            }(std::index_sequence_for<Ts...>());
+
+            return ec;
+        }
+    }
+
+    /**
+     * Parses the entire string as a value of type T.
+     *
+     * Numbers are parsed with 'std::from_chars', so no leading whitespace or
+     * plus sign is accepted and the result does not depend on the locale.
+     * Booleans are spelled "true", "false", "1" or "0".
+     */
+    template <parsable T>
+    auto parse(std::string_view string) -> parse_result<T> {
+        auto value = T();
+        const auto ec = detail::parse_into(string, value);
+
+        if (ec != std::errc()) return ec;
+        return value;
+    }
+
+    /**
+     * Splits a line on 'delimiter' and parses each field as the
+     * corresponding type. The line must contain exactly one field per type.
+     */
+    template <parsable... Ts>
+    auto split_parse(std::string_view line, std::string_view delimiter)
+        -> parse_result<std::tuple<Ts...>> {
+        auto values = std::tuple<Ts...>();
+        const auto ec = detail::parse_fields(line, delimiter, values);
+
+        if (ec != std::errc()) return ec;
+        return values;
+    }
+
+    /**
+     * Like 'split_parse', but constructs an S from the parsed fields.
+     */
+    template <typename S, parsable... Ts>
+    auto split_parse_as(std::string_view line, std::string_view delimiter)
+        -> parse_result<S> {
+        auto values = std::tuple<Ts...>();
+        const auto ec = detail::parse_fields(line, delimiter, values);
+
+        if (ec != std::errc()) return ec;
+        return std::make_from_tuple<S>(std::move(values));
+    }
+
+    /**
+     * Splits a line on 'delimiter' and appends each parsed field to the
+     * corresponding column.
+     *
+     * Nothing is appended unless every field parses and every column has
+     * room for another element; 'std::errc::no_buffer_space' is returned in
+     * the latter case.
+     */
+    template <parsable... Ts, typename... Allocators>
+    auto split_parse_into(
+        std::string_view line,
+        std::string_view delimiter,
+        dynarray<Ts, Allocators>&... columns
+    ) -> std::errc {
+        if ((... || (columns.size() == columns.capacity()))) {
+            return std::errc::no_buffer_space;
+        }
+
+        auto values = std::tuple<Ts...>();
+        const auto ec = detail::parse_fields(line, delimiter, values);
+
+        if (ec != std::errc()) return ec;
+
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (columns.emplace_back(std::move(std::get<I>(values))), ...);
+        }(std::index_sequence_for<Ts...>());
+
+        return std::errc();
+    }
+}
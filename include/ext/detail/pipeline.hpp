@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../unix.h"
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ext {
+    /**
+     * Runs several programs at once with the standard output of each
+     * connected to the standard input of the next, like 'a | b | c' in a
+     * shell.
+     *
+     * All stages are spawned before any of them is waited for, so data
+     * streams through the pipes while the stages run concurrently.
+     */
+    class pipeline final {
+        struct stage {
+            std::string program;
+            std::vector<std::string> args;
+            spawn_options options;
+        };
+
+        std::vector<stage> stages;
+        std::optional<int> buffer_size;
+    public:
+        /**
+         * Appends a stage. The standard input of every stage but the first
+         * and the standard output of every stage but the last are connected
+         * to pipes; the corresponding settings in 'options' are ignored.
+         */
+        auto add(
+            std::string_view program,
+            std::span<const std::string_view> args = {},
+            spawn_options options = {}
+        ) -> pipeline&;
+
+        template <typename... Args>
+        auto operator()(std::string_view program, Args&&... args)
+            -> pipeline& {
+            const auto arg_list = std::vector<std::string_view> {args...};
+            return add(program, arg_list);
+        }
+
+        /**
+         * Sets the capacity of the pipes between stages with F_SETPIPE_SZ.
+         * The kernel rounds the size up to a power-of-two number of pages;
+         * unprivileged processes are limited by /proc/sys/fs/pipe-max-size.
+         */
+        auto pipe_size(int size) -> pipeline&;
+
+        /**
+         * Starts all stages and waits for them to terminate, returning the
+         * exit status of each stage in order.
+         *
+         * If the input of the first stage or the output of the last stage
+         * is a pipe, use 'start' and service the pipe instead, or the
+         * pipeline may never finish.
+         */
+        auto run() const -> std::vector<exit_status>;
+
+        /**
+         * Like 'run', but also adds the resources used by every stage to
+         * 'total'.
+         */
+        auto run(resource_usage& total) const -> std::vector<exit_status>;
+
+        auto size() const noexcept -> std::size_t;
+
+        /**
+         * Starts all stages and returns their processes in order.
+         *
+         * If a stage cannot be started, the stages that were already
+         * started are waited for before the exception is rethrown.
+         */
+        auto start() const -> std::vector<process>;
+    };
+}
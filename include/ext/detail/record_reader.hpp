@@ -0,0 +1,95 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ext {
+    struct record_options {
+        char delimiter = ',';
+
+        // The character that surrounds quoted fields. Quoting is disabled if
+        // this is the null character.
+        char quote = '"';
+    };
+
+    /**
+     * Parses delimited records such as CSV or TSV.
+     *
+     * Records are separated by line feeds; a carriage return before the line
+     * feed is ignored. A field that begins with the quote character may
+     * contain delimiters, line breaks and doubled quote characters, which
+     * stand for a single quote character.
+     *
+     * Input may be given all at once or in chunks of any size. Fields are
+     * views into the input wherever possible: only fields containing escaped
+     * quotes, and records that span chunks, are copied. The views returned
+     * by 'next' remain valid until 'next' or 'feed' is called again,
+     * provided the chunk they came from is still alive.
+     */
+    class record_reader final {
+        record_options options;
+        std::string_view input;
+        std::size_t position = 0;
+        bool last = false;
+
+        // Input carried over from earlier chunks. Bytes before
+        // 'partial_position' have been returned; bytes before 'scanned'
+        // have been checked for the end of the current record.
+        std::string partial;
+        std::size_t partial_position = 0;
+        std::size_t scanned = 0;
+
+        enum class scan_state { field_start, unquoted, quoted, quote };
+        scan_state state = scan_state::field_start;
+
+        std::vector<std::string_view> fields;
+        std::string scratch;
+
+        struct unescaped_field {
+            std::size_t index;
+            std::size_t offset;
+            std::size_t length;
+        };
+
+        std::vector<unescaped_field> unescaped;
+
+        auto parse(const char* begin, const char* end, bool final)
+            -> const char*;
+
+        auto scan(const char* it, const char* end) -> const char*;
+
+        auto take_partial(std::size_t end, bool final)
+            -> std::span<const std::string_view>;
+    public:
+        explicit record_reader(record_options options = {});
+
+        /**
+         * Creates a reader for a complete buffer.
+         */
+        explicit record_reader(
+            std::string_view buffer,
+            record_options options = {}
+        );
+
+        /**
+         * Supplies the next chunk of input. The chunk must remain valid until
+         * 'next' has returned all records that end in it.
+         */
+        auto feed(std::string_view chunk) -> void;
+
+        /**
+         * Signals that no more input will follow, so that a final record not
+         * terminated by a line feed can be returned.
+         */
+        auto finish() -> void;
+
+        /**
+         * Returns the fields of the next record, or nothing if more input is
+         * needed or the input is exhausted.
+         */
+        auto next() -> std::optional<std::span<const std::string_view>>;
+    };
+}
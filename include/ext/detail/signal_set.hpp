@@ -0,0 +1,106 @@
+#pragma once
+
+#include "coroutine/awaiter_queue.hpp"
+
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <csignal>
+#include <cstddef>
+#include <initializer_list>
+#include <sys/signalfd.h>
+
+namespace ext {
+    /**
+     * Delivers POSIX signals to coroutines through a signalfd.
+     *
+     * Creating a set blocks its signals in the calling thread so that they
+     * are queued for the descriptor instead of running a handler; the
+     * previous signal mask is restored when the set is destroyed. Signals
+     * sent to the process are only guaranteed to reach the descriptor if
+     * every thread blocks them, so create the set before starting other
+     * threads. Processes started with ext::spawn begin with an empty signal
+     * mask regardless.
+     *
+     * Pending signals are read in batches, so a burst of signals, such as
+     * SIGCHLD from many children at once, is drained with a single read.
+     * Standard signals of the same number that arrive while one is pending
+     * are merged by the kernel, as they are for handlers.
+     *
+     * A signal set is not thread-safe; it is meant to be driven by 'poll' on
+     * the thread that owns it.
+     */
+    class signal_set final {
+        static constexpr auto batch_size = 64;
+
+        int fd;
+        sigset_t previous;
+        awaiter_queue waiting;
+        std::array<signalfd_siginfo, batch_size> buffer;
+        std::size_t first = 0;
+        std::size_t last = 0;
+
+        /**
+         * Reads any pending signals into the buffer without blocking.
+         * Returns false if no signals are pending.
+         */
+        auto fill() -> bool;
+
+        auto take() noexcept -> signalfd_siginfo;
+    public:
+        class awaiter final {
+            signal_set& signals;
+            awaiter_node node;
+
+            friend class signal_set;
+
+            explicit awaiter(signal_set& signals) noexcept;
+        public:
+            awaiter(const awaiter&) = delete;
+
+            auto operator=(const awaiter&) -> awaiter& = delete;
+
+            auto await_ready() -> bool;
+
+            auto await_suspend(std::coroutine_handle<> coroutine) noexcept
+                -> void;
+
+            auto await_resume() noexcept -> signalfd_siginfo;
+        };
+
+        explicit signal_set(std::initializer_list<int> signals);
+
+        signal_set(const signal_set&) = delete;
+
+        ~signal_set();
+
+        auto operator=(const signal_set&) -> signal_set& = delete;
+
+        /**
+         * Returns true if no coroutine is waiting for a signal.
+         */
+        auto empty() const noexcept -> bool;
+
+        /**
+         * The signalfd, for use with an external event loop. When it becomes
+         * readable, call 'poll' with a timeout of zero.
+         */
+        auto native_handle() const noexcept -> int;
+
+        /**
+         * Returns an awaitable that completes with the next signal in the
+         * set. Coroutines waiting at the same time receive signals in the
+         * order in which they started waiting.
+         */
+        auto next() noexcept -> awaiter;
+
+        /**
+         * Waits up to 'timeout' for signals and hands them to waiting
+         * coroutines. A negative timeout waits indefinitely. Returns the
+         * number of coroutines resumed.
+         */
+        auto poll(
+            std::chrono::milliseconds timeout = std::chrono::milliseconds(-1)
+        ) -> std::size_t;
+    };
+}
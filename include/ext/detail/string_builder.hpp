@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <vector>
+
+namespace ext {
+    /**
+     * Assembles a large string from many pieces without reallocating.
+     *
+     * Appended text is copied into a chain of chunks that grow geometrically
+     * up to a maximum size; existing chunks are never moved. The result can
+     * be written out with 'writev' directly from the chunks, or copied into
+     * a single string with 'flatten' when a contiguous buffer is needed.
+     *
+     * The builder works with 'std::back_inserter', so it can be used as the
+     * output of 'fmt::format_to' and 'ext::join_to'.
+     */
+    class string_builder final {
+        struct chunk {
+            std::unique_ptr<char[]> data;
+            std::size_t size;
+            std::size_t capacity;
+        };
+
+        std::vector<chunk> chunks;
+        std::size_t chunk_size;
+        std::size_t length = 0;
+
+        auto add_chunk(std::size_t min_capacity) -> chunk&;
+    public:
+        using value_type = char;
+
+        static constexpr std::size_t default_chunk_size = 4096;
+
+        static constexpr std::size_t max_chunk_size = 1024 * 1024;
+
+        explicit string_builder(
+            std::size_t chunk_size = default_chunk_size
+        ) noexcept;
+
+        auto operator+=(std::string_view string) -> string_builder&;
+
+        auto append(std::string_view string) -> string_builder&;
+
+        /**
+         * Releases all chunks.
+         */
+        auto clear() noexcept -> void;
+
+        auto empty() const noexcept -> bool;
+
+        /**
+         * Copies the contents into a single string.
+         */
+        auto flatten() const -> std::string;
+
+        /**
+         * Returns an array of buffers describing the contents, suitable for
+         * passing to 'writev'. The buffers remain valid until the builder is
+         * cleared or destroyed.
+         */
+        auto iovecs() const -> std::vector<iovec>;
+
+        auto push_back(char c) -> void;
+
+        auto size() const noexcept -> std::size_t;
+
+        /**
+         * Writes the entire contents to the file descriptor, retrying after
+         * partial writes.
+         */
+        auto write(int fd) const -> void;
+    };
+}
@@ -0,0 +1,363 @@
+#pragma once
+
+#include "coroutine/jtask.hpp"
+#include "coroutine/result.hpp"
+#include "coroutine/task.hpp"
+
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ext {
+    namespace detail {
+        /**
+         * A Chase-Lev work-stealing deque.
+         *
+         * One thread, the owner, pushes and pops items at the bottom; any
+         * other thread may steal items from the top. The owner's operations
+         * need no atomic read-modify-write unless a single item is left.
+         * The memory orderings follow Lê et al., "Correct and Efficient
+         * Work-Stealing for Weak Memory Models" (PPoPP 2013).
+         *
+         * When the ring buffer fills, the owner replaces it with one twice
+         * the size. Replaced buffers are kept until the deque is destroyed,
+         * since a thief may still be reading from one.
+         */
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        class work_stealing_deque final {
+            class ring {
+                std::size_t mask;
+                std::unique_ptr<std::atomic<T>[]> items;
+            public:
+                explicit ring(std::size_t capacity) :
+                    mask(capacity - 1),
+                    items(new std::atomic<T>[capacity]) {}
+
+                auto capacity() const noexcept -> std::size_t {
+                    return mask + 1;
+                }
+
+                auto get(std::int64_t index) const noexcept -> T {
+                    return items[index & mask].load(std::memory_order_relaxed);
+                }
+
+                auto put(std::int64_t index, T item) noexcept -> void {
+                    items[index & mask].store(item, std::memory_order_relaxed);
+                }
+            };
+
+            alignas(64) std::atomic<std::int64_t> top = 0;
+            alignas(64) std::atomic<std::int64_t> bottom = 0;
+            std::atomic<ring*> buffer;
+            std::vector<std::unique_ptr<ring>> rings;
+
+            auto grow(ring* old, std::int64_t first, std::int64_t last)
+                -> ring* {
+                auto* const bigger =
+                    rings.emplace_back(new ring(old->capacity() * 2)).get();
+
+                for (auto i = first; i < last; ++i) {
+                    bigger->put(i, old->get(i));
+                }
+
+                buffer.store(bigger, std::memory_order_release);
+                return bigger;
+            }
+        public:
+            explicit work_stealing_deque(std::size_t capacity = 256) {
+                buffer.store(
+                    rings.emplace_back(new ring(std::bit_ceil(capacity)))
+                        .get(),
+                    std::memory_order_relaxed
+                );
+            }
+
+            work_stealing_deque(const work_stealing_deque&) = delete;
+
+            auto operator=(const work_stealing_deque&)
+                -> work_stealing_deque& = delete;
+
+            /**
+             * Returns true if the deque appeared empty at some point during
+             * the call. Safe to call from any thread.
+             */
+            auto empty() const noexcept -> bool {
+                const auto b = bottom.load(std::memory_order_relaxed);
+                const auto t = top.load(std::memory_order_relaxed);
+                return b <= t;
+            }
+
+            /**
+             * Removes the most recently pushed item. Owner only.
+             */
+            auto pop() -> std::optional<T> {
+                const auto b = bottom.load(std::memory_order_relaxed) - 1;
+                auto* const a = buffer.load(std::memory_order_relaxed);
+
+                bottom.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                auto t = top.load(std::memory_order_relaxed);
+
+                if (t > b) {
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                    return std::nullopt;
+                }
+
+                auto item = std::optional<T>(a->get(b));
+
+                if (t == b) {
+                    // The last item: race any thieves for it.
+                    if (!top.compare_exchange_strong(
+                            t,
+                            t + 1,
+                            std::memory_order_seq_cst,
+                            std::memory_order_relaxed
+                        )) {
+                        item.reset();
+                    }
+
+                    bottom.store(b + 1, std::memory_order_relaxed);
+                }
+
+                return item;
+            }
+
+            /**
+             * Adds an item at the bottom. Owner only.
+             */
+            auto push(T item) -> void {
+                const auto b = bottom.load(std::memory_order_relaxed);
+                const auto t = top.load(std::memory_order_acquire);
+                auto* a = buffer.load(std::memory_order_relaxed);
+
+                if (b - t > std::int64_t(a->capacity()) - 1) a = grow(a, t, b);
+
+                a->put(b, item);
+                std::atomic_thread_fence(std::memory_order_release);
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+
+            /**
+             * Removes the least recently pushed item. Safe to call from any
+             * thread; fails if the deque is empty or another thread took
+             * the item first.
+             */
+            auto steal() -> std::optional<T> {
+                auto t = top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const auto b = bottom.load(std::memory_order_acquire);
+
+                if (t >= b) return std::nullopt;
+
+                auto* const a = buffer.load(std::memory_order_acquire);
+                const auto item = a->get(t);
+
+                if (!top.compare_exchange_strong(
+                        t,
+                        t + 1,
+                        std::memory_order_seq_cst,
+                        std::memory_order_relaxed
+                    )) {
+                    return std::nullopt;
+                }
+
+                return item;
+            }
+        };
+
+        /**
+         * A one-shot event that a thread blocks on until another thread
+         * sets it.
+         */
+        class sync_wait_event final {
+            std::mutex mutex;
+            std::condition_variable condition;
+            bool done = false;
+        public:
+            auto set() -> void {
+                // Notify while holding the lock: the waiter may destroy the
+                // event as soon as it can observe 'done'.
+                const auto lock = std::lock_guard(mutex);
+                done = true;
+                condition.notify_one();
+            }
+
+            auto wait() -> void {
+                auto lock = std::unique_lock(mutex);
+                condition.wait(lock, [this] { return done; });
+            }
+        };
+
+        template <typename T>
+        class sync_wait_task final {
+        public:
+            struct promise_type final : result<T> {
+                sync_wait_event* event = nullptr;
+
+                struct final_awaitable {
+                    auto await_ready() const noexcept -> bool { return false; }
+
+                    auto await_suspend(
+                        std::coroutine_handle<promise_type> coroutine
+                    ) const noexcept -> void {
+                        coroutine.promise().event->set();
+                    }
+
+                    auto await_resume() const noexcept -> void {}
+                };
+
+                auto get_return_object() noexcept -> sync_wait_task {
+                    return sync_wait_task(
+                        std::coroutine_handle<promise_type>::from_promise(*this)
+                    );
+                }
+
+                auto initial_suspend() const noexcept {
+                    return std::suspend_always();
+                }
+
+                auto final_suspend() const noexcept {
+                    return final_awaitable();
+                }
+            };
+        private:
+            std::coroutine_handle<promise_type> coroutine;
+
+            explicit sync_wait_task(
+                std::coroutine_handle<promise_type> coroutine
+            ) noexcept :
+                coroutine(coroutine) {}
+        public:
+            sync_wait_task(const sync_wait_task&) = delete;
+
+            ~sync_wait_task() { coroutine.destroy(); }
+
+            auto operator=(const sync_wait_task&) -> sync_wait_task& = delete;
+
+            auto run() -> T {
+                auto event = sync_wait_event();
+
+                coroutine.promise().event = &event;
+                coroutine.resume();
+                event.wait();
+
+                return std::move(coroutine.promise()).get();
+            }
+        };
+
+        template <typename T, typename Awaitable>
+        auto make_sync_wait_task(Awaitable awaitable) -> sync_wait_task<T> {
+            co_return co_await std::move(awaitable);
+        }
+    }
+
+    /**
+     * Runs coroutines on a fixed set of worker threads.
+     *
+     * Each worker keeps its own work-stealing deque. A coroutine scheduled
+     * from a worker is pushed onto that worker's deque, and an idle worker
+     * takes work from the others, so fan-out from a coroutine spreads
+     * across cores without a shared queue. Coroutines scheduled from
+     * outside the pool go through a shared injection queue.
+     *
+     * The pool must be idle when it is destroyed: coroutines still queued
+     * are never resumed.
+     */
+    class thread_pool final {
+        struct worker {
+            detail::work_stealing_deque<std::coroutine_handle<>> deque;
+        };
+
+        std::vector<std::unique_ptr<worker>> workers;
+
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::deque<std::coroutine_handle<>> injected;
+        std::uint64_t epoch = 0;
+        std::atomic<unsigned int> sleeping = 0;
+        std::atomic<bool> stopping = false;
+
+        std::vector<std::jthread> threads;
+
+        auto find_work(std::size_t index) -> std::coroutine_handle<>;
+
+        auto run(std::size_t index) -> void;
+
+        auto wake() -> void;
+    public:
+        class schedule_awaiter final {
+            thread_pool& pool;
+
+            friend class thread_pool;
+
+            explicit schedule_awaiter(thread_pool& pool) noexcept :
+                pool(pool) {}
+        public:
+            auto await_ready() const noexcept -> bool { return false; }
+
+            auto await_suspend(std::coroutine_handle<> coroutine) -> void {
+                pool.post(coroutine);
+            }
+
+            auto await_resume() const noexcept -> void {}
+        };
+
+        /**
+         * Starts the given number of worker threads; by default, one per
+         * hardware thread.
+         */
+        explicit thread_pool(
+            unsigned int threads = std::thread::hardware_concurrency()
+        );
+
+        thread_pool(const thread_pool&) = delete;
+
+        ~thread_pool();
+
+        auto operator=(const thread_pool&) -> thread_pool& = delete;
+
+        /**
+         * Queues a suspended coroutine to be resumed on a worker.
+         */
+        auto post(std::coroutine_handle<> coroutine) -> void;
+
+        /**
+         * Returns an awaitable that resumes the awaiting coroutine on one of
+         * the pool's workers.
+         */
+        auto schedule() noexcept -> schedule_awaiter;
+
+        auto size() const noexcept -> std::size_t;
+    };
+
+    /**
+     * Starts 'target' on the calling thread and blocks until it completes,
+     * possibly on another thread, returning its result.
+     */
+    template <typename T>
+    auto sync_wait(task<T> target) -> T {
+        return detail::make_sync_wait_task<T>(std::move(target)).run();
+    }
+
+    /**
+     * Blocks until 'target', which has already started, completes.
+     */
+    template <typename T>
+    auto sync_wait(jtask<T>& target) -> T {
+        detail::make_sync_wait_task<void>(target.when_ready()).run();
+        return std::move(target).result();
+    }
+}
@@ -6,5 +6,7 @@
 namespace ext {
     struct system_error : std::system_error {
         system_error(const std::string& message);
+
+        system_error(std::error_code ec, const std::string& message);
     };
 }
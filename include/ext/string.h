@@ -1,9 +1,19 @@
 #pragma once
 
+#include "detail/flat_hash_map.hpp"
+#include "detail/hash.hpp"
+#include "detail/no_spec_formatter.hpp"
+
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <fmt/format.h>
 #include <functional>
 #include <iterator>
+#include <ranges>
 #include <regex>
 #include <sstream>
 #include <string>
@@ -20,7 +30,19 @@
 #define QUOTE_VIEW(string_view) QUOTE(std::string(string_view))
 
 namespace ext {
-    using string_map = std::unordered_map<std::string, std::string>;
+    /**
+     * A map of strings that can be searched with a std::string_view without
+     * allocating a temporary key.
+     */
+    using string_map = std::
+        unordered_map<std::string, std::string, string_hash, std::equal_to<>>;
+
+    /**
+     * Like string_map, but stores its elements inline in a single array
+     * rather than allocating a node for each one.
+     */
+    using flat_string_map =
+        flat_hash_map<std::string, std::string, string_hash, std::equal_to<>>;
 
     /**
      * Replaces any environment variables in the specified string with their
@@ -32,32 +54,158 @@ namespace ext {
      */
     auto expand_env(std::string_view sequence) -> std::string;
 
+    namespace detail {
+        template <typename T>
+        concept string_like = std::convertible_to<const T&, std::string_view>;
+
+        template <typename T>
+        concept char_like = std::same_as<T, char> ||
+                            std::same_as<T, signed char> ||
+                            std::same_as<T, unsigned char>;
+
+        template <typename T>
+        concept number = std::is_arithmetic_v<T> && !char_like<T>;
+
+        /**
+         * Calls 'write' with the textual representation of 'value'.
+         *
+         * Strings are passed through unchanged and numbers are converted
+         * with std::to_chars into a stack buffer; anything else falls back to
+         * its stream insertion operator.
+         */
+        template <typename T, typename Write>
+        auto to_chars(const T& value, Write&& write) -> void {
+            using type = std::remove_cvref_t<T>;
+
+            if constexpr (string_like<type>) write(std::string_view(value));
+            else if constexpr (char_like<type>) {
+                const auto c = static_cast<char>(value);
+                write(std::string_view(&c, 1));
+            }
+            else if constexpr (std::same_as<type, bool>) {
+                write(value ? std::string_view("1") : std::string_view("0"));
+            }
+            else if constexpr (number<type>) {
+                char buffer[64];
+                const auto result =
+                    std::to_chars(buffer, buffer + sizeof(buffer), value);
+                write(std::string_view(buffer, result.ptr));
+            }
+            else {
+                auto os = std::ostringstream();
+                os << value;
+                write(std::string_view(os.view()));
+            }
+        }
+
+        template <typename R, typename Proj>
+        using projected_t = std::remove_cvref_t<
+            std::indirect_result_t<Proj&, std::ranges::iterator_t<R>>>;
+    }
+
     /**
-     * Returns a new string composed of copies of the Container elements joined
-     * together with a copy of the specified delimiter.
+     * Writes the elements of a range separated by a delimiter to an output
+     * iterator.
      *
+     * @param out The iterator to write to.
      * @param elements The elements to join together.
      * @param delimiter The delimiter that separates each element.
-     * @return A new string that is composed of the elements separated by the
-     * delimiter.
+     * @param proj A projection applied to each element before it is written.
+     * @return An iterator past the last character written.
      */
     template <
-        typename Container,
-        typename Value = typename Container::value_type>
-    auto join(const Container& elements, const char* delimiter) -> std::string {
-        auto os = std::ostringstream();
-        auto begin = elements.begin();
-        auto end = elements.end();
+        typename Out,
+        std::ranges::input_range R,
+        typename Proj = std::identity>
+    requires std::output_iterator<Out, char>
+    auto join_to(
+        Out out,
+        R&& elements,
+        std::string_view delimiter,
+        Proj proj = {}
+    ) -> Out {
+        const auto write = [&out](std::string_view text) {
+            out = std::ranges::copy(text, out).out;
+        };
+
+        auto first = true;
 
-        if (begin != end) {
-            auto it = std::ostream_iterator<Value>(os, delimiter);
-            std::copy(begin, std::prev(end), it);
+        for (auto&& element : elements) {
+            if (first) first = false;
+            else write(delimiter);
 
-            begin = std::prev(end);
-            if (begin != end) os << *begin;
+            detail::to_chars(std::invoke(proj, element), write);
         }
 
-        return os.str();
+        return out;
+    }
+
+    /**
+     * Appends the elements of a range separated by a delimiter to a string.
+     *
+     * When the range can be traversed more than once and its (projected)
+     * elements are string-like, the total size is computed first so that the
+     * string is grown at most once.
+     *
+     * @param out The string to append to.
+     * @param elements The elements to join together.
+     * @param delimiter The delimiter that separates each element.
+     * @param proj A projection applied to each element before it is written.
+     * @return A reference to 'out'.
+     */
+    template <std::ranges::input_range R, typename Proj = std::identity>
+    auto join_to(
+        std::string& out,
+        R&& elements,
+        std::string_view delimiter,
+        Proj proj = {}
+    ) -> std::string& {
+        using value_type = detail::projected_t<R, Proj>;
+
+        if constexpr (std::ranges::forward_range<R> &&
+                      detail::string_like<value_type>) {
+            auto size = std::size_t(0);
+            auto count = std::size_t(0);
+
+            for (auto&& element : elements) {
+                size += std::string_view(std::invoke(proj, element)).size();
+                ++count;
+            }
+
+            if (count > 1) size += delimiter.size() * (count - 1);
+            out.reserve(out.size() + size);
+        }
+
+        const auto write = [&out](std::string_view text) { out.append(text); };
+
+        auto first = true;
+
+        for (auto&& element : elements) {
+            if (first) first = false;
+            else out.append(delimiter);
+
+            detail::to_chars(std::invoke(proj, element), write);
+        }
+
+        return out;
+    }
+
+    /**
+     * Returns a new string composed of copies of the range's elements joined
+     * together with a copy of the specified delimiter.
+     *
+     * @param elements The elements to join together.
+     * @param delimiter The delimiter that separates each element.
+     * @param proj A projection applied to each element before it is written.
+     * @return A new string that is composed of the elements separated by the
+     * delimiter.
+     */
+    template <std::ranges::input_range R, typename Proj = std::identity>
+    auto join(R&& elements, std::string_view delimiter, Proj proj = {})
+        -> std::string {
+        auto result = std::string();
+        join_to(result, std::forward<R>(elements), delimiter, std::move(proj));
+        return result;
     }
 
     /**
@@ -104,12 +252,234 @@ namespace ext {
         return os.str();
     }
 
+    /**
+     * A set of bytes backed by a 256-bit lookup table.
+     */
+    class charset {
+        std::array<std::uint64_t, 4> bits = {};
+    public:
+        constexpr charset() noexcept = default;
+
+        constexpr charset(std::string_view chars) noexcept {
+            for (const auto c : chars) insert(c);
+        }
+
+        constexpr charset(const char* chars) noexcept :
+            charset(std::string_view(chars)) {}
+
+        constexpr auto contains(char c) const noexcept -> bool {
+            const auto byte = static_cast<unsigned char>(c);
+            return (bits[byte >> 6] >> (byte & 63)) & 1;
+        }
+
+        /**
+         * Returns the position of the first character at or after 'pos' that
+         * is in the set, or 'npos' if there is none.
+         */
+        constexpr auto find(std::string_view string, std::size_t pos = 0)
+            const noexcept -> std::size_t {
+            for (; pos < string.size(); ++pos) {
+                if (contains(string[pos])) return pos;
+            }
+
+            return std::string_view::npos;
+        }
+
+        /**
+         * Returns the position of the first character at or after 'pos' that
+         * is not in the set, or 'npos' if there is none.
+         */
+        constexpr auto find_not(std::string_view string, std::size_t pos = 0)
+            const noexcept -> std::size_t {
+            for (; pos < string.size(); ++pos) {
+                if (!contains(string[pos])) return pos;
+            }
+
+            return std::string_view::npos;
+        }
+
+        constexpr auto insert(char c) noexcept -> void {
+            const auto byte = static_cast<unsigned char>(c);
+            bits[byte >> 6] |= std::uint64_t(1) << (byte & 63);
+        }
+    };
+
+    /**
+     * The ASCII whitespace characters, as classified by std::isspace in the
+     * "C" locale.
+     */
+    constexpr auto whitespace = charset(" \t\n\v\f\r");
+
+    /**
+     * Returns the position of the first occurrence of 'needle' in 'haystack'
+     * at or after 'pos', or 'npos' if there is none.
+     *
+     * Equivalent to 'std::string_view::find', but scans 16 bytes at a time
+     * for candidates whose first and last bytes match before comparing the
+     * rest of the needle.
+     */
+    auto find(
+        std::string_view haystack,
+        std::string_view needle,
+        std::size_t pos = 0
+    ) noexcept -> std::size_t;
+
+    /**
+     * A lazily evaluated sequence of the positions of non-overlapping
+     * occurrences of a string.
+     */
+    class match_range {
+        std::string_view haystack;
+        std::string_view needle;
+    public:
+        match_range(std::string_view haystack, std::string_view needle) :
+            haystack(haystack),
+            needle(needle) {}
+
+        class iterator {
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::size_t;
+            using pointer = const value_type*;
+            using reference = value_type;
+            using iterator_category = std::forward_iterator_tag;
+        private:
+            const match_range* range = nullptr;
+            value_type pos = std::string_view::npos;
+        public:
+            iterator() = default;
+
+            iterator(const match_range* range) :
+                range(range),
+                pos(
+                    range->needle.empty()
+                        ? std::string_view::npos
+                        : ext::find(range->haystack, range->needle)
+                ) {}
+
+            auto operator++() -> iterator& {
+                pos = ext::find(
+                    range->haystack,
+                    range->needle,
+                    pos + range->needle.size()
+                );
+                return *this;
+            }
+
+            auto operator++(int) -> iterator {
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+            auto operator==(const iterator& other) const -> bool {
+                return pos == other.pos;
+            }
+
+            auto operator*() const -> reference { return pos; }
+        };
+
+        auto begin() const -> iterator { return iterator(this); }
+
+        auto end() const -> iterator { return iterator(); }
+    };
+
+    /**
+     * Returns the positions of all non-overlapping occurrences of 'needle'
+     * in 'haystack', found as the range is iterated. An empty needle has no
+     * matches.
+     */
+    inline auto find_all(std::string_view haystack, std::string_view needle)
+        -> match_range {
+        return match_range(haystack, needle);
+    }
+
+    struct split_options {
+        /**
+         * Treat a run of adjacent delimiters as a single delimiter.
+         */
+        bool collapse = false;
+
+        /**
+         * Do not produce empty tokens, including those before a leading or
+         * after a trailing delimiter.
+         */
+        bool skip_empty = false;
+    };
+
     class string_range {
         const std::string delimiter;
+        const charset delimiters;
+        const bool any_of = false;
+        const split_options options;
         const std::string_view sequence;
+
+        auto find_delimiter(std::size_t pos) const noexcept -> std::size_t {
+            return any_of ? delimiters.find(sequence, pos)
+                          : ext::find(sequence, delimiter, pos);
+        }
+
+        /**
+         * Returns the start of the token following the delimiter at 'pos'.
+         */
+        auto next_token(std::size_t pos) const noexcept -> std::size_t {
+            if (any_of) {
+                ++pos;
+
+                if (options.collapse || options.skip_empty) {
+                    pos = std::min(
+                        delimiters.find_not(sequence, pos),
+                        sequence.size()
+                    );
+                }
+
+                return pos;
+            }
+
+            pos += delimiter.size();
+
+            if (options.collapse || options.skip_empty) {
+                while (!delimiter.empty() &&
+                       sequence.substr(pos).starts_with(delimiter)) {
+                    pos += delimiter.size();
+                }
+            }
+
+            return pos;
+        }
     public:
-        string_range(std::string_view sequence, std::string_view delimiter) :
+        string_range(
+            std::string_view sequence,
+            std::string_view delimiter,
+            split_options options = {}
+        ) :
             delimiter(delimiter),
+            options(options),
+            sequence(sequence) {}
+
+        /**
+         * Resolves the ambiguity between the string and set delimiter
+         * overloads for string literals, which are treated as a single
+         * delimiter.
+         */
+        string_range(
+            std::string_view sequence,
+            const char* delimiter,
+            split_options options = {}
+        ) :
+            string_range(sequence, std::string_view(delimiter), options) {}
+
+        /**
+         * Splits the sequence on any of the characters in 'delimiters'.
+         */
+        string_range(
+            std::string_view sequence,
+            const charset& delimiters,
+            split_options options = {}
+        ) :
+            delimiters(delimiters),
+            any_of(true),
+            options(options),
             sequence(sequence) {}
 
         class iterator {
@@ -124,22 +494,43 @@ namespace ext {
             difference_type last;
             const string_range* range;
 
+            auto empty() const noexcept -> bool {
+                const auto end =
+                    last == value_type::npos ? range->sequence.size() : last;
+                return first == end;
+            }
+
+            auto skip_empty() -> void {
+                while (range->options.skip_empty && empty()) {
+                    if (last == value_type::npos) {
+                        first = value_type::npos;
+                        return;
+                    }
+
+                    first = range->next_token(last);
+                    last = range->find_delimiter(first);
+                }
+            }
+
             auto advance() -> void {
                 if (last == value_type::npos) {
                     first = value_type::npos;
                     return;
                 }
 
-                first = last + range->delimiter.size();
-                last = range->sequence.find(range->delimiter, first);
+                first = range->next_token(last);
+                last = range->find_delimiter(first);
+                skip_empty();
             }
         public:
             iterator() : first(value_type::npos), last(value_type::npos) {}
 
             iterator(const string_range* range) :
                 first(0),
-                last(range->sequence.find(range->delimiter)),
-                range(range) {}
+                last(range->find_delimiter(0)),
+                range(range) {
+                skip_empty();
+            }
 
             auto operator++() -> iterator& {
                 advance();
@@ -170,18 +561,50 @@ namespace ext {
         auto end() -> iterator { return iterator(); }
     };
 
-    auto split(std::string_view sequence, std::string_view delimiter)
-        -> std::vector<std::string_view>;
+    auto split(
+        std::string_view sequence,
+        std::string_view delimiter,
+        split_options options = {}
+    ) -> std::vector<std::string_view>;
+
+    auto split(
+        std::string_view sequence,
+        const char* delimiter,
+        split_options options = {}
+    ) -> std::vector<std::string_view>;
+
+    /**
+     * Splits the sequence on any of the characters in 'delimiters'.
+     */
+    auto split(
+        std::string_view sequence,
+        const charset& delimiters,
+        split_options options = {}
+    ) -> std::vector<std::string_view>;
 
     /**
      * Returns a new string with all leading and trailing whitespace removed
      * from the given string.
      *
+     * Only ASCII whitespace is removed; the current locale is not consulted.
+     *
      * @param string The string from which to remove whitespace.
      * @return A new string with all leading and trailing whitespace removed.
      */
     auto trim(std::string_view string) -> std::string_view;
 
+    /**
+     * Returns a new string with all leading and trailing characters contained
+     * in the given set removed.
+     *
+     * @param string The string to trim.
+     * @param chars The characters to remove.
+     * @return A new string with all leading and trailing characters in the
+     * set removed.
+     */
+    auto trim(std::string_view string, const charset& chars)
+        -> std::string_view;
+
     /**
      * Returns a new string with all leading whitespace removed from the given
      * string.
@@ -191,6 +614,13 @@ namespace ext {
      */
     auto trim_start(std::string_view string) -> std::string_view;
 
+    /**
+     * Returns a new string with all leading characters contained in the given
+     * set removed.
+     */
+    auto trim_start(std::string_view string, const charset& chars)
+        -> std::string_view;
+
     /**
      * Returns a new string with all trailing whitespace removed from the given
      * string.
@@ -200,8 +630,56 @@ namespace ext {
      */
     auto trim_end(std::string_view string) -> std::string_view;
 
+    /**
+     * Returns a new string with all trailing characters contained in the
+     * given set removed.
+     */
+    auto trim_end(std::string_view string, const charset& chars)
+        -> std::string_view;
+
+    namespace utf8 {
+        /**
+         * Returns true if every byte in the string is an ASCII character.
+         */
+        auto is_ascii(std::string_view string) noexcept -> bool;
+
+        /**
+         * Returns the number of code points in a valid UTF-8 string.
+         *
+         * The string is not validated: the result is the number of bytes
+         * that are not continuation bytes.
+         */
+        auto length(std::string_view string) noexcept -> std::size_t;
+
+        /**
+         * Returns true if the string is well-formed UTF-8. Overlong
+         * encodings, surrogates, code points beyond U+10FFFF and truncated
+         * sequences are rejected.
+         */
+        auto validate(std::string_view string) noexcept -> bool;
+    }
+
+    /**
+     * Formats a string surrounded with special quotation marks.
+     */
+    struct quoted {
+        std::string_view text;
+    };
+
     /**
      * Surrounds the given string with special quotation marks.
      */
     auto quote(std::string_view text) -> std::string;
 }
+
+template <>
+struct fmt::formatter<ext::quoted> : ext::detail::no_spec_formatter {
+    auto format(const ext::quoted& quoted, format_context& ctx) const
+        -> decltype(ctx.out()) {
+        constexpr auto mark = std::string_view("‘");
+
+        auto out = std::copy(mark.begin(), mark.end(), ctx.out());
+        out = std::copy(quoted.text.begin(), quoted.text.end(), out);
+        return std::copy(mark.begin(), mark.end(), out);
+    }
+};
@@ -1,12 +1,23 @@
 #pragma once
 
+#include "detail/coroutine/generator.hpp"
+#include "detail/coroutine/task.hpp"
+#include "detail/no_spec_formatter.hpp"
+#include "string.h"
+
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <fmt/format.h>
+#include <functional>
 #include <grp.h>
+#include <memory>
 #include <optional>
 #include <pwd.h>
 #include <span>
 #include <string>
 #include <sys/wait.h>
+#include <system_error>
 #include <variant>
 #include <vector>
 
@@ -19,6 +30,23 @@ namespace ext {
 
         group(std::variant<gid_t, std::string> value);
 
+        /**
+         * Looks up a group by ID or name, returning an empty optional if no
+         * such group exists. Throws if the group database cannot be read.
+         */
+        static auto lookup(std::variant<gid_t, std::string> value)
+            -> std::optional<group>;
+
+        /**
+         * Looks up a group without throwing. If the group database cannot
+         * be read, 'ec' is set and an empty optional is returned; a missing
+         * group is not an error.
+         */
+        static auto lookup(
+            const std::variant<gid_t, std::string>& value,
+            std::error_code& ec
+        ) noexcept -> std::optional<group>;
+
         auto gid() const -> gid_t;
 
         auto name() const -> std::string_view;
@@ -34,6 +62,23 @@ namespace ext {
 
         user(std::variant<uid_t, std::string> value);
 
+        /**
+         * Looks up a user by ID or name, returning an empty optional if no
+         * such user exists. Throws if the user database cannot be read.
+         */
+        static auto lookup(std::variant<uid_t, std::string> value)
+            -> std::optional<user>;
+
+        /**
+         * Looks up a user without throwing. If the user database cannot
+         * be read, 'ec' is set and an empty optional is returned; a missing
+         * user is not an error.
+         */
+        static auto lookup(
+            const std::variant<uid_t, std::string>& value,
+            std::error_code& ec
+        ) noexcept -> std::optional<user>;
+
         auto gid() const -> gid_t;
 
         auto home() const -> std::string_view;
@@ -51,6 +96,13 @@ namespace ext {
 
     auto chown(const std::filesystem::path& path, uid_t uid, gid_t gid) -> void;
 
+    auto chown(
+        const std::filesystem::path& path,
+        uid_t uid,
+        gid_t gid,
+        std::error_code& ec
+    ) noexcept -> void;
+
     auto chown(const std::filesystem::path& path, const user& owner) -> void;
 
     auto chown(const std::filesystem::path& path, const group& group) -> void;
@@ -67,24 +119,401 @@ namespace ext {
         const std::optional<group>& group
     ) -> void;
 
+    struct chown_error {
+        std::filesystem::path path;
+        std::error_code error;
+    };
+
+    struct chown_tree_options {
+        /**
+         * The number of threads that walk directories, including the calling
+         * thread.
+         */
+        unsigned int threads = 1;
+
+        /**
+         * Called for each entry that could not be read or changed. Calls are
+         * serialized, but may come from any of the walking threads.
+         */
+        std::function<void(const chown_error&)> on_error;
+    };
+
+    struct chown_tree_result {
+        std::size_t changed = 0;
+        std::size_t unchanged = 0;
+        std::size_t failed = 0;
+    };
+
+    /**
+     * Changes the ownership of 'root' and everything beneath it, like
+     * 'chown -hR'. An ID of -1 leaves that part of the ownership as is.
+     *
+     * Directories are opened relative to their parent's descriptor and
+     * symbolic links are never followed, so entries are not resolved from
+     * the root on every call and a link swapped in during the walk cannot
+     * redirect it. Entries that already have the requested owner and group
+     * are not modified. Errors are reported to 'options.on_error' and do not
+     * stop the walk.
+     */
+    auto chown_tree(
+        const std::filesystem::path& root,
+        uid_t uid,
+        gid_t gid,
+        const chown_tree_options& options = {}
+    ) -> chown_tree_result;
+
+    auto chown_tree(
+        const std::filesystem::path& root,
+        const std::optional<user>& owner,
+        const std::optional<group>& group,
+        const chown_tree_options& options = {}
+    ) -> chown_tree_result;
+
     auto exec(std::string_view program, std::span<const std::string_view> args)
         -> void;
 
+    /**
+     * Replaces the current process image. Returns only on failure, with the
+     * reason stored in 'ec'.
+     */
+    auto exec(
+        std::string_view program,
+        std::span<const std::string_view> args,
+        std::error_code& ec
+    ) noexcept -> void;
+
+    /**
+     * Owns a file descriptor, closing it on destruction.
+     */
+    class unique_fd final {
+        int fd = -1;
+    public:
+        unique_fd() noexcept = default;
+
+        explicit unique_fd(int fd) noexcept;
+
+        unique_fd(const unique_fd&) = delete;
+
+        unique_fd(unique_fd&& other) noexcept;
+
+        ~unique_fd();
+
+        auto operator=(const unique_fd&) -> unique_fd& = delete;
+
+        auto operator=(unique_fd&& other) noexcept -> unique_fd&;
+
+        explicit operator bool() const noexcept;
+
+        auto get() const noexcept -> int;
+
+        /**
+         * Gives up ownership of the descriptor without closing it.
+         */
+        auto release() noexcept -> int;
+
+        /**
+         * Closes the current descriptor, if any, and takes ownership of
+         * 'fd'.
+         */
+        auto reset(int fd = -1) noexcept -> void;
+    };
+
+    struct pipe_fds {
+        unique_fd read;
+        unique_fd write;
+    };
+
+    /**
+     * Creates a pipe whose ends are closed on exec.
+     */
+    auto open_pipe() -> pipe_fds;
+
+    /**
+     * Moves up to 'length' bytes from 'in' to 'out' without copying them
+     * through user space. At least one of the descriptors must refer to a
+     * pipe. Returns the number of bytes moved, which is zero at end of input.
+     */
+    auto splice(int in, int out, std::size_t length, unsigned int flags = 0)
+        -> std::size_t;
+
+    /**
+     * Moves everything from 'in' to 'out' with 'splice' until the end of the
+     * input, and returns the number of bytes moved.
+     */
+    auto splice_all(int in, int out) -> std::size_t;
+
+    /**
+     * Duplicates up to 'length' bytes from the pipe 'in' to the pipe 'out'
+     * without consuming them. Returns the number of bytes duplicated.
+     */
+    auto tee(int in, int out, std::size_t length, unsigned int flags = 0)
+        -> std::size_t;
+
+    /**
+     * Reads from a file descriptor through a reusable buffer.
+     *
+     * Views returned by the reader refer to its buffer and remain valid only
+     * until the next read.
+     */
+    class fd_reader final {
+        int fd;
+        std::unique_ptr<char[]> buffer;
+        std::size_t capacity;
+        std::size_t first = 0;
+        std::size_t last = 0;
+        bool eof = false;
+
+        auto fill() -> void;
+    public:
+        static constexpr std::size_t default_buffer_size = 64 * 1024;
+
+        /**
+         * Creates a reader for 'fd', which the reader does not own.
+         */
+        explicit fd_reader(
+            int fd,
+            std::size_t buffer_size = default_buffer_size
+        );
+
+        /**
+         * Returns the next chunk of input, or an empty view at end of
+         * input.
+         */
+        auto read() -> std::string_view;
+
+        /**
+         * Yields each line of the remaining input without its line feed.
+         * The buffer grows as needed to hold a whole line. The final line
+         * need not end in a line feed.
+         */
+        auto lines() -> generator<std::string_view>;
+    };
+
     struct exit_status {
         int code;
         int status;
+
+        auto operator==(const exit_status&) const -> bool = default;
+    };
+
+    /**
+     * Resources consumed by a terminated child process, as reported by the
+     * kernel when the child is reaped.
+     */
+    struct resource_usage {
+        std::chrono::microseconds user_time = {};
+        std::chrono::microseconds system_time = {};
+
+        /**
+         * The peak resident set size, in bytes.
+         */
+        std::uint64_t max_rss = 0;
+
+        /**
+         * Page faults serviced without and with I/O.
+         */
+        std::uint64_t minor_faults = 0;
+        std::uint64_t major_faults = 0;
+
+        std::uint64_t voluntary_switches = 0;
+        std::uint64_t involuntary_switches = 0;
+
+        /**
+         * Adds the usage of another process. Times and counts are summed;
+         * 'max_rss' becomes the larger of the two peaks, since the processes
+         * may not have run at the same time.
+         */
+        auto operator+=(const resource_usage& other) -> resource_usage&;
+
+        auto operator==(const resource_usage&) const -> bool = default;
     };
 
+    /**
+     * How a standard stream of a spawned process is set up.
+     */
+    enum class stdio {
+        /**
+         * Share the parent's stream.
+         */
+        inherit,
+
+        /**
+         * Connect the stream to /dev/null.
+         */
+        null,
+
+        /**
+         * Connect the stream to a pipe whose other end is held by the
+         * process object.
+         */
+        pipe
+    };
+
+    /**
+     * Makes 'parent', a file descriptor in the calling process, available as
+     * 'child' in a spawned process.
+     */
+    struct fd_mapping {
+        int child;
+        int parent;
+    };
+
+    struct spawn_options {
+        /**
+         * The working directory of the child. By default, the child starts
+         * in the parent's working directory.
+         */
+        std::optional<std::filesystem::path> directory;
+
+        /**
+         * The complete environment of the child. By default, the child
+         * inherits the parent's environment.
+         */
+        std::optional<string_map> environment;
+
+        stdio in = stdio::inherit;
+        stdio out = stdio::inherit;
+        stdio err = stdio::inherit;
+
+        /**
+         * File descriptors to set up in the child, applied in order after
+         * the standard streams.
+         */
+        std::vector<fd_mapping> fds;
+
+        /**
+         * Descriptors that stay open in the child under the same number,
+         * even if they are marked close-on-exec.
+         */
+        std::vector<int> keep_fds;
+
+        /**
+         * Close every descriptor in the child except the standard streams,
+         * the targets of 'fds' and those in 'keep_fds', rather than relying
+         * on each descriptor being marked close-on-exec. Descriptors above
+         * the highest one kept are closed with a single action; those below
+         * it are closed one at a time.
+         */
+        bool close_fds = false;
+    };
+
+    /**
+     * Returns a copy of the calling process's environment, suitable as a
+     * starting point for 'spawn_options::environment'.
+     */
+    auto environment() -> string_map;
+
+    class child_monitor;
+
+    class event_loop;
+
+    class process;
+
+    namespace detail {
+        /**
+         * Spawns a process from prepared argument and environment arrays.
+         * A null 'envp' inherits the parent's environment; the environment
+         * in 'options' is ignored.
+         */
+        auto spawn(
+            char* const* argv,
+            char* const* envp,
+            const spawn_options& options
+        ) -> process;
+    }
+
+    /**
+     * Starts 'program' in a new process with the given arguments, searching
+     * PATH if the name contains no slash.
+     *
+     * The process is created with posix_spawn, which does not copy the
+     * parent's address space, so the cost does not grow with the size of the
+     * parent and it is safe to call from a multithreaded program. The child
+     * starts with an empty signal mask and default signal dispositions.
+     */
+    auto spawn(
+        std::string_view program,
+        std::span<const std::string_view> args,
+        const spawn_options& options = {}
+    ) -> process;
+
     class process {
-        const pid_t _pid;
+        pid_t _pid;
+        unique_fd in;
+        unique_fd out;
+        unique_fd err;
 
         process(pid_t pid);
+
+        friend auto detail::spawn(
+            char* const* argv,
+            char* const* envp,
+            const spawn_options& options
+        ) -> process;
     public:
         static auto fork() -> std::optional<process>;
 
+        process(const process&) = delete;
+
+        process(process&&) noexcept = default;
+
+        auto operator=(const process&) -> process& = delete;
+
+        auto operator=(process&&) noexcept -> process& = default;
+
+        /**
+         * Waits for the process to terminate without blocking the thread,
+         * using 'monitor' to detect termination. The task completes when
+         * the monitor resumes it after the process exits.
+         */
+        auto async_wait(child_monitor& monitor) const -> task<exit_status>;
+
+        /**
+         * Waits for the process to terminate on 'loop' by awaiting its
+         * pidfd, then reaps it.
+         */
+        auto async_wait(event_loop& loop) const -> task<exit_status>;
+
+        /**
+         * Like 'async_wait', but also stores the resources the process used
+         * in 'usage', which must outlive the task.
+         */
+        auto async_wait(child_monitor& monitor, resource_usage& usage) const
+            -> task<exit_status>;
+
         auto pid() const -> pid_t;
 
+        /**
+         * The parent's end of the child's standard input, if it was spawned
+         * with a pipe for it. Reset the descriptor to signal end of input.
+         */
+        auto stdin_fd() noexcept -> unique_fd&;
+
+        /**
+         * The parent's end of the child's standard output, if it was spawned
+         * with a pipe for it.
+         */
+        auto stdout_fd() noexcept -> unique_fd&;
+
+        /**
+         * The parent's end of the child's standard error, if it was spawned
+         * with a pipe for it.
+         */
+        auto stderr_fd() noexcept -> unique_fd&;
+
         auto wait() const -> exit_status;
+
+        /**
+         * Waits for the process to terminate without throwing. On failure,
+         * 'ec' is set and the returned status is meaningless.
+         */
+        auto wait(std::error_code& ec) const noexcept -> exit_status;
+
+        /**
+         * Waits for the process to terminate and stores the resources it
+         * used in 'usage'.
+         */
+        auto wait(resource_usage& usage) const -> exit_status;
     };
 
     auto exec_bg(
@@ -103,3 +532,13 @@ namespace ext {
         return wait_exec(program, arg_list);
     }
 }
+
+/**
+ * Describes how a process terminated, for example "exited with status 1" or
+ * "killed by signal 9".
+ */
+template <>
+struct fmt::formatter<ext::exit_status> : ext::detail::no_spec_formatter {
+    auto format(const ext::exit_status& status, format_context& ctx) const
+        -> decltype(ctx.out());
+};
@@ -9,6 +9,8 @@ FetchContent_Declare(fmt
 
 FetchContent_MakeAvailable(fmt)
 
+find_package(Threads REQUIRED)
+
 if(PROJECT_TESTING)
     FetchContent_Declare(GTest
         GIT_REPOSITORY https://github.com/google/googletest.git
@@ -0,0 +1,82 @@
+#include <ext/detail/arena.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace ext {
+    arena::arena(std::size_t block_size) noexcept : block_size(block_size) {}
+
+    arena::arena(arena&& other) noexcept :
+        blocks(std::move(other.blocks)),
+        cursor(std::exchange(other.cursor, nullptr)),
+        limit(std::exchange(other.limit, nullptr)),
+        block_size(other.block_size),
+        used(std::exchange(other.used, 0)) {}
+
+    auto arena::operator=(arena&& other) noexcept -> arena& {
+        if (std::addressof(other) != this) {
+            blocks = std::move(other.blocks);
+            cursor = std::exchange(other.cursor, nullptr);
+            limit = std::exchange(other.limit, nullptr);
+            block_size = other.block_size;
+            used = std::exchange(other.used, 0);
+        }
+
+        return *this;
+    }
+
+    auto arena::allocate_block(std::size_t size) -> std::byte* {
+        auto data = std::unique_ptr<std::byte[]>(new std::byte[size]);
+        auto* const result = data.get();
+
+        blocks.push_back({std::move(data), size});
+        return result;
+    }
+
+    auto arena::allocate(std::size_t size, std::size_t alignment) -> void* {
+        const auto address = reinterpret_cast<std::uintptr_t>(cursor);
+        const auto padding = (alignment - address % alignment) % alignment;
+
+        if (cursor && padding + size <= std::size_t(limit - cursor)) {
+            auto* const result = cursor + padding;
+            cursor = result + size;
+            used += size;
+            return result;
+        }
+
+        // Allocations too large to share a block get one of their own, so
+        // that the unused space in the current block is not abandoned.
+        const auto worst_case = size + alignment - 1;
+        if (worst_case > block_size / 2) {
+            auto* const data = allocate_block(worst_case);
+            const auto offset = reinterpret_cast<std::uintptr_t>(data);
+            used += size;
+            return data + (alignment - offset % alignment) % alignment;
+        }
+
+        cursor = allocate_block(block_size);
+        limit = cursor + block_size;
+
+        return allocate(size, alignment);
+    }
+
+    auto arena::clear() noexcept -> void {
+        blocks.clear();
+        cursor = nullptr;
+        limit = nullptr;
+        used = 0;
+    }
+
+    auto arena::copy(std::string_view string) -> std::string_view {
+        auto* const data =
+            static_cast<char*>(allocate(string.size() + 1, alignof(char)));
+
+        if (!string.empty()) std::memcpy(data, string.data(), string.size());
+        data[string.size()] = '\0';
+
+        return {data, string.size()};
+    }
+
+    auto arena::size() const noexcept -> std::size_t { return used; }
+}
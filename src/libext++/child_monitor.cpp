@@ -0,0 +1,71 @@
+#include <ext/child_monitor>
+#include <ext/except.h>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    auto pidfd_open(pid_t pid) -> int {
+        const auto fd = static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+        if (fd == -1) throw ext::system_error("failed to open pidfd");
+        return fd;
+    }
+}
+
+namespace ext {
+    child_monitor::awaiter::pidfd_watch::pidfd_watch(
+        event_loop& loop,
+        pid_t pid
+    ) :
+        loop(loop),
+        fd(pidfd_open(pid)) {}
+
+    child_monitor::awaiter::pidfd_watch::~pidfd_watch() {
+        loop.remove(fd);
+        close(fd);
+    }
+
+    child_monitor::awaiter::awaiter(child_monitor& monitor, pid_t pid) :
+        monitor(monitor),
+        pidfd(monitor.loop, pid),
+        exit(monitor.loop.readable(pidfd.fd)) {}
+
+    child_monitor::awaiter::~awaiter() {
+        if (registered) --monitor.waiting;
+    }
+
+    auto child_monitor::awaiter::await_suspend(
+        std::coroutine_handle<> coroutine
+    ) -> void {
+        exit.await_suspend(coroutine);
+
+        registered = true;
+        ++monitor.waiting;
+    }
+
+    auto child_monitor::awaiter::await_resume() noexcept -> void {
+        registered = false;
+        --monitor.waiting;
+    }
+
+    child_monitor::child_monitor() :
+        owned(std::make_unique<event_loop>()),
+        loop(*owned) {}
+
+    child_monitor::child_monitor(event_loop& loop) : loop(loop) {}
+
+    auto child_monitor::empty() const noexcept -> bool { return waiting == 0; }
+
+    auto child_monitor::exited(pid_t pid) -> awaiter {
+        return awaiter(*this, pid);
+    }
+
+    auto child_monitor::poll(std::chrono::milliseconds timeout)
+        -> std::size_t {
+        return loop.run_once(timeout);
+    }
+
+    auto child_monitor::run() -> void {
+        while (!empty()) loop.run_once();
+    }
+}
@@ -0,0 +1,119 @@
+#include <ext/unix.h>
+
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+    class ChownTree : public testing::Test {
+    protected:
+        fs::path root;
+
+        auto SetUp() -> void override {
+            char path[] = "/tmp/ext.chown.XXXXXX";
+            ASSERT_NE(nullptr, mkdtemp(path));
+            root = path;
+
+            // 1 root + 3 directories + 3 * 4 files + 1 symlink
+            for (const auto* const dir : {"a", "b", "b/c"}) {
+                fs::create_directory(root / dir);
+
+                for (auto i = 0; i < 4; ++i) {
+                    std::ofstream(root / dir / std::to_string(i)) << i;
+                }
+            }
+
+            fs::create_symlink("/", root / "a/link");
+        }
+
+        auto TearDown() -> void override { fs::remove_all(root); }
+
+        static auto owner(const fs::path& path) -> std::pair<uid_t, gid_t> {
+            struct stat st;
+            lstat(path.c_str(), &st);
+            return {st.st_uid, st.st_gid};
+        }
+    };
+
+    constexpr auto entries = 17;
+}
+
+TEST_F(ChownTree, Unchanged) {
+    const auto result = ext::chown_tree(root, getuid(), getgid());
+
+    EXPECT_EQ(0, result.changed);
+    EXPECT_EQ(entries, result.unchanged);
+    EXPECT_EQ(0, result.failed);
+}
+
+TEST_F(ChownTree, Change) {
+    if (geteuid() != 0) GTEST_SKIP() << "changing ownership requires root";
+
+    const auto result = ext::chown_tree(
+        root,
+        1234,
+        5678,
+        {.threads = 4, .on_error = nullptr}
+    );
+
+    EXPECT_EQ(entries, result.changed);
+    EXPECT_EQ(0, result.unchanged);
+    EXPECT_EQ(0, result.failed);
+
+    EXPECT_EQ(std::pair(uid_t(1234), gid_t(5678)), owner(root));
+    EXPECT_EQ(std::pair(uid_t(1234), gid_t(5678)), owner(root / "b/c/3"));
+    EXPECT_EQ(std::pair(uid_t(1234), gid_t(5678)), owner(root / "a/link"));
+
+    // Symbolic links are not followed.
+    EXPECT_EQ(std::pair(uid_t(0), gid_t(0)), owner("/"));
+
+    const auto again = ext::chown_tree(root, -1, 5678);
+
+    EXPECT_EQ(0, again.changed);
+    EXPECT_EQ(entries, again.unchanged);
+}
+
+TEST_F(ChownTree, Threads) {
+    for (auto i = 0; i < 50; ++i) {
+        fs::create_directories(root / "wide" / std::to_string(i) / "x");
+    }
+
+    const auto result = ext::chown_tree(
+        root,
+        getuid(),
+        getgid(),
+        {.threads = 8, .on_error = nullptr}
+    );
+
+    EXPECT_EQ(entries + 101, result.unchanged);
+    EXPECT_EQ(0, result.failed);
+}
+
+TEST_F(ChownTree, Errors) {
+    auto errors = std::vector<ext::chown_error>();
+    const auto options = ext::chown_tree_options {
+        .on_error = [&](const auto& error) { errors.push_back(error); }
+    };
+
+    const auto result = ext::chown_tree(root / "missing", -1, -1, options);
+
+    EXPECT_EQ(1, result.failed);
+    ASSERT_EQ(1, errors.size());
+    EXPECT_EQ(root / "missing", errors.front().path);
+    EXPECT_EQ(std::errc::no_such_file_or_directory, errors.front().error);
+}
+
+TEST_F(ChownTree, ErrorCode) {
+    auto ec = std::error_code();
+
+    ext::chown(root, getuid(), getgid(), ec);
+    EXPECT_FALSE(ec);
+
+    ext::chown(root / "missing", getuid(), getgid(), ec);
+    EXPECT_EQ(std::errc::no_such_file_or_directory, ec);
+}
@@ -1,19 +1,22 @@
 #include <ext/chrono.h>
 
+#include <algorithm>
 #include <ctime>
-#include <iomanip>
 #include <stdexcept>
 
 namespace ext::chrono {
-    static auto to_tm(const timestamp& ts) -> std::tm* {
-        auto time = clock::to_time_t(ts.time());
+    static auto to_tm(const timestamp& ts) -> std::tm {
+        const auto time = clock::to_time_t(ts.time());
+        auto tm = std::tm();
 
         switch (ts.type()) {
-            case gmt: return std::gmtime(&time);
-            case local: return std::localtime(&time);
+            case gmt: gmtime_r(&time, &tm); break;
+            case local: localtime_r(&time, &tm); break;
             default:
                 throw std::runtime_error("Unhandled 'time_type' enumerator");
         }
+
+        return tm;
     }
 
     timestamp::timestamp(std::string_view format, time_type type) :
@@ -21,12 +24,13 @@ namespace ext::chrono {
         m_time(clock::now()),
         m_type(type) {}
 
-    auto timestamp::format() const -> std::string { return m_format; }
+    auto timestamp::format() const -> const std::string& { return m_format; }
 
     auto timestamp::strftime(int buffer_size) const -> std::string {
         char buffer[buffer_size];
+        const auto tm = to_tm(*this);
         auto bytes_written =
-            std::strftime(buffer, buffer_size, m_format.c_str(), to_tm(*this));
+            std::strftime(buffer, buffer_size, m_format.c_str(), &tm);
 
         if (bytes_written == 0) return "";
         return buffer;
@@ -37,7 +41,47 @@ namespace ext::chrono {
     auto timestamp::type() const -> time_type { return m_type; }
 
     auto operator<<(std::ostream& os, const timestamp& ts) -> std::ostream& {
-        os << std::put_time(to_tm(ts), ts.format().c_str());
-        return os;
+        auto buffer = fmt::memory_buffer();
+        fmt::format_to(fmt::appender(buffer), "{}", ts);
+        return os.write(buffer.data(), buffer.size());
     }
 }
+
+auto fmt::formatter<ext::chrono::timestamp>::format(
+    const ext::chrono::timestamp& ts,
+    format_context& ctx
+) const -> decltype(ctx.out()) {
+    // Large enough for typical formats without touching the heap.
+    constexpr auto initial_size = std::size_t(128);
+
+    // Only reached if strftime fails for some reason other than the size
+    // of the buffer.
+    constexpr auto max_size = std::size_t(64 * 1024);
+
+    const auto& format = ts.format();
+    if (format.empty()) return ctx.out();
+
+    // strftime returns zero both for an output that does not fit and for
+    // an empty one. A trailing sentinel character makes every output
+    // nonempty, so zero always means the buffer is too small.
+    auto spec = fmt::basic_memory_buffer<char, initial_size>();
+    spec.append(format);
+    spec.push_back(' ');
+    spec.push_back('\0');
+
+    const auto tm = ext::chrono::to_tm(ts);
+    auto buffer = fmt::basic_memory_buffer<char, initial_size>();
+
+    for (auto size = initial_size; size <= max_size; size *= 2) {
+        buffer.resize(size);
+
+        const auto written =
+            std::strftime(buffer.data(), size, spec.data(), &tm);
+
+        if (written > 0) {
+            return std::copy_n(buffer.data(), written - 1, ctx.out());
+        }
+    }
+
+    return ctx.out();
+}
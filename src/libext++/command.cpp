@@ -0,0 +1,107 @@
+#include <ext/command>
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <memory>
+#include <stdexcept>
+
+namespace ext {
+    command::command(
+        std::string_view program,
+        std::span<const argument> args,
+        spawn_options options
+    ) :
+        options(std::move(options)) {
+        argv.reserve(args.size() + 2);
+        argv.push_back(store(program));
+
+        for (const auto& arg : args) {
+            if (const auto* const value = std::get_if<std::string_view>(&arg)) {
+                argv.push_back(store(*value));
+            }
+            else {
+                slot_indices.push_back(argv.size());
+                argv.push_back(nullptr);
+            }
+        }
+
+        argv.push_back(nullptr);
+
+        if (auto& environment = this->options.environment) {
+            envp.reserve(environment->size() + 1);
+
+            for (const auto& [key, value] : *environment) {
+                envp.push_back(store(fmt::format("{}={}", key, value)));
+            }
+
+            envp.push_back(nullptr);
+            environment.reset();
+        }
+    }
+
+    command::command(
+        std::string_view program,
+        std::initializer_list<argument> args,
+        spawn_options options
+    ) :
+        command(
+            program,
+            std::span<const argument>(args.begin(), args.size()),
+            std::move(options)
+        ) {}
+
+    auto command::store(std::string_view string) -> char* {
+        // The strings are never modified; exec functions merely take
+        // non-const pointers for historical reasons.
+        return const_cast<char*>(storage.copy(string).data());
+    }
+
+    auto command::run(std::span<const std::string_view> values) const
+        -> exit_status {
+        return spawn(values).wait();
+    }
+
+    auto command::slots() const noexcept -> std::size_t {
+        return slot_indices.size();
+    }
+
+    auto command::spawn(std::span<const std::string_view> values) const
+        -> process {
+        if (values.size() != slot_indices.size()) {
+            throw std::invalid_argument(fmt::format(
+                "command expects {} argument{}; {} given",
+                slot_indices.size(),
+                slot_indices.size() == 1 ? "" : "s",
+                values.size()
+            ));
+        }
+
+        if (slot_indices.empty()) {
+            return detail::spawn(
+                argv.data(),
+                envp.empty() ? nullptr : envp.data(),
+                options
+            );
+        }
+
+        auto size = values.size();
+        for (const auto value : values) size += value.size();
+
+        auto buffer = std::unique_ptr<char[]>(new char[size]);
+        auto* cursor = buffer.get();
+
+        auto args = argv;
+
+        for (auto i = 0ul; i < values.size(); ++i) {
+            args[slot_indices[i]] = cursor;
+            cursor = std::ranges::copy(values[i], cursor).out;
+            *cursor++ = '\0';
+        }
+
+        return detail::spawn(
+            args.data(),
+            envp.empty() ? nullptr : envp.data(),
+            options
+        );
+    }
+}
@@ -0,0 +1,93 @@
+#include <ext/command>
+
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std::literals;
+
+namespace {
+    auto exited(int status) -> ext::exit_status {
+        return {.code = CLD_EXITED, .status = status};
+    }
+}
+
+TEST(Command, Fixed) {
+    const auto command = ext::command("test", {"a b", "=", "a b"});
+
+    EXPECT_EQ(0, command.slots());
+    EXPECT_EQ(exited(0), command.run());
+    EXPECT_EQ(exited(0), command.run());
+}
+
+TEST(Command, Slots) {
+    const auto command =
+        ext::command("test", {ext::command::slot, "=", ext::command::slot});
+
+    EXPECT_EQ(2, command.slots());
+
+    const auto same = std::array {"foo"sv, "foo"sv};
+    const auto different = std::array {"foo"sv, "a longer value"sv};
+
+    EXPECT_EQ(exited(0), command.run(same));
+    EXPECT_EQ(exited(1), command.run(different));
+    EXPECT_EQ(exited(0), command.run(same));
+}
+
+TEST(Command, WrongArgumentCount) {
+    const auto command = ext::command("test", {ext::command::slot});
+    EXPECT_THROW(command.spawn(), std::invalid_argument);
+}
+
+TEST(Command, Environment) {
+    auto options = ext::spawn_options();
+    options.environment = ext::string_map {{"FOO", "bar"}};
+
+    const auto command = ext::command(
+        "sh",
+        {"-c", "test \"$FOO\" = \"$1\"", "sh", ext::command::slot},
+        options
+    );
+
+    const auto bar = std::array {"bar"sv};
+    const auto baz = std::array {"baz"sv};
+
+    EXPECT_EQ(exited(0), command.run(bar));
+    EXPECT_EQ(exited(1), command.run(baz));
+}
+
+TEST(Command, Output) {
+    auto options = ext::spawn_options();
+    options.out = ext::stdio::pipe;
+
+    const auto command =
+        ext::command("echo", {"-n", ext::command::slot}, options);
+
+    const auto value = std::array {"hello"sv};
+    auto process = command.spawn(value);
+
+    auto reader = ext::fd_reader(process.stdout_fd().get());
+    auto output = std::string();
+    for (auto chunk = reader.read(); !chunk.empty(); chunk = reader.read()) {
+        output.append(chunk);
+    }
+
+    EXPECT_EQ("hello", output);
+    EXPECT_EQ(exited(0), process.wait());
+}
+
+TEST(Command, Concurrent) {
+    const auto command =
+        ext::command("test", {ext::command::slot, "=", ext::command::slot});
+    auto threads = std::vector<std::jthread>();
+
+    for (auto i = 0; i < 4; ++i) {
+        threads.emplace_back([&command, i] {
+            const auto value = std::to_string(i);
+            const auto args = std::array<std::string_view, 2> {value, value};
+
+            for (auto j = 0; j < 10; ++j) {
+                EXPECT_EQ(exited(0), command.run(args));
+            }
+        });
+    }
+}
@@ -1,27 +1,55 @@
 #include <ext/data_size.h>
 
-#include <iomanip>
+namespace {
+    auto write(
+        fmt::appender out,
+        double value,
+        ext::byte_multiple multiple,
+        int precision
+    ) -> fmt::appender {
+        const auto multiplier = std::pow(10.0, precision);
+        const auto rounded = std::ceil(value * multiplier) / multiplier;
 
-namespace ext {
-    auto operator<<(std::ostream& os, byte_multiple multiple) -> std::ostream& {
-        switch (multiple) {
-            case byte_multiple::B: os << "B"; break;
-            case byte_multiple::KiB: os << "KiB"; break;
-            case byte_multiple::MiB: os << "MiB"; break;
-            case byte_multiple::GiB: os << "GiB"; break;
-            case byte_multiple::TiB: os << "TiB"; break;
+        auto buffer = fmt::memory_buffer();
+        fmt::format_to(fmt::appender(buffer), "{:.{}f}", rounded, precision);
+
+        auto number = std::string_view(buffer.data(), buffer.size());
+
+        if (number.find('.') != std::string_view::npos) {
+            while (number.ends_with('0')) number.remove_suffix(1);
+            if (number.ends_with('.')) number.remove_suffix(1);
         }
 
-        return os;
+        return fmt::format_to(out, "{} {}", number, multiple);
+    }
+}
+
+namespace ext {
+    auto operator<<(std::ostream& os, byte_multiple multiple) -> std::ostream& {
+        return os << detail::byte_multiple_name(multiple);
     }
 
     auto data_size::str(uint decimal_places) const -> std::string {
-        const auto multiplier = std::pow(10.0, decimal_places);
-        const auto rounded = std::ceil(value * multiplier) / multiplier;
+        auto buffer = fmt::memory_buffer();
+        write(fmt::appender(buffer), value, multiple, decimal_places);
+        return fmt::to_string(buffer);
+    }
+}
 
-        auto os = std::ostringstream();
-        os << rounded << " " << multiple;
+auto fmt::formatter<ext::data_size>::format(
+    const ext::data_size& size,
+    format_context& ctx
+) const -> decltype(ctx.out()) {
+    if (!unit) return write(ctx.out(), size.value, size.multiple, precision);
 
-        return os.str();
-    }
+    const auto divisor = static_cast<double>(
+        std::uintmax_t(1) << (static_cast<int>(*unit) * 10)
+    );
+
+    return write(
+        ctx.out(),
+        static_cast<double>(size.bytes) / divisor,
+        *unit,
+        precision
+    );
 }
@@ -0,0 +1,333 @@
+#include <ext/event_loop>
+#include <ext/except.h>
+
+#include <algorithm>
+#include <array>
+#include <fmt/format.h>
+#include <unistd.h>
+
+namespace {
+    constexpr auto read_events = std::uint32_t(EPOLLIN | EPOLLRDHUP);
+    constexpr auto write_events = std::uint32_t(EPOLLOUT);
+    constexpr auto edge_events =
+        std::uint32_t(EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET);
+}
+
+namespace ext {
+    event_loop::ready_node::~ready_node() {
+        if (queue) queue->remove(*this);
+    }
+
+    auto event_loop::ready_queue::pop() noexcept -> ready_node* {
+        auto* const node = head;
+        if (node) remove(*node);
+        return node;
+    }
+
+    auto event_loop::ready_queue::push(ready_node& node) noexcept -> void {
+        node.queue = this;
+        node.prev = tail;
+        node.next = nullptr;
+
+        if (tail) tail->next = &node;
+        else head = &node;
+
+        tail = &node;
+    }
+
+    auto event_loop::ready_queue::remove(ready_node& node) noexcept -> void {
+        if (node.prev) node.prev->next = node.next;
+        else head = node.next;
+
+        if (node.next) node.next->prev = node.prev;
+        else tail = node.prev;
+
+        node.queue = nullptr;
+        node.prev = nullptr;
+        node.next = nullptr;
+    }
+
+    auto event_loop::ready_queue::splice(ready_queue& other) noexcept
+        -> void {
+        if (other.empty()) return;
+
+        for (auto* node = other.head; node; node = node->next) {
+            node->queue = this;
+        }
+
+        other.head->prev = tail;
+
+        if (tail) tail->next = other.head;
+        else head = other.head;
+
+        tail = other.tail;
+
+        other.head = nullptr;
+        other.tail = nullptr;
+    }
+
+    event_loop::io_awaiter::io_awaiter(
+        event_loop& loop,
+        int fd,
+        bool write
+    ) noexcept :
+        loop(loop),
+        fd(fd),
+        write(write) {}
+
+    event_loop::io_awaiter::~io_awaiter() {
+        if (registered) loop.remove(*this);
+    }
+
+    auto event_loop::io_awaiter::await_suspend(
+        std::coroutine_handle<> coroutine
+    ) -> void {
+        this->coroutine = coroutine;
+        loop.add(*this);
+    }
+
+    event_loop::timer_awaiter::timer_awaiter(
+        event_loop& loop,
+        clock::time_point deadline
+    ) noexcept :
+        loop(loop),
+        deadline(deadline) {}
+
+    event_loop::timer_awaiter::~timer_awaiter() {
+        if (registered) {
+            loop.timers.erase(timer);
+            --loop.waiting;
+        }
+    }
+
+    auto event_loop::timer_awaiter::await_ready() const noexcept -> bool {
+        return deadline <= clock::now();
+    }
+
+    auto event_loop::timer_awaiter::await_suspend(
+        std::coroutine_handle<> coroutine
+    ) -> void {
+        this->coroutine = coroutine;
+        timer = loop.timers.emplace(deadline, this);
+        registered = true;
+        ++loop.waiting;
+    }
+
+    event_loop::event_loop(event_loop_options options) :
+        epoll(epoll_create1(EPOLL_CLOEXEC)),
+        options(options),
+        events(options.max_events) {
+        if (epoll == -1) throw ext::system_error("failed to create epoll fd");
+    }
+
+    event_loop::~event_loop() { close(epoll); }
+
+    auto event_loop::add(io_awaiter& awaiter) -> void {
+        auto& w = watches[awaiter.fd];
+        auto*& slot = awaiter.write ? w.writer : w.reader;
+
+        if (slot) {
+            throw std::logic_error(fmt::format(
+                "a coroutine is already waiting for fd {} to become {}",
+                awaiter.fd,
+                awaiter.write ? "writable" : "readable"
+            ));
+        }
+
+        slot = &awaiter;
+
+        try {
+            update(awaiter.fd, w);
+        }
+        catch (...) {
+            slot = nullptr;
+            throw;
+        }
+
+        awaiter.registered = true;
+        ++waiting;
+    }
+
+    auto event_loop::empty() const noexcept -> bool {
+        return waiting == 0 && ready.empty();
+    }
+
+    auto event_loop::readable(int fd) noexcept -> io_awaiter {
+        return io_awaiter(*this, fd, false);
+    }
+
+    auto event_loop::remove(io_awaiter& awaiter) noexcept -> void {
+        const auto it = watches.find(awaiter.fd);
+        auto& w = it->second;
+
+        (awaiter.write ? w.writer : w.reader) = nullptr;
+        awaiter.registered = false;
+        --waiting;
+
+        try {
+            update(awaiter.fd, w);
+        }
+        catch (...) {
+            // The descriptor may already have been closed, in which case
+            // the kernel has dropped its registration.
+            w.events = 0;
+        }
+    }
+
+    auto event_loop::remove(int fd) -> void {
+        const auto it = watches.find(fd);
+        if (it == watches.end()) return;
+
+        if (it->second.reader || it->second.writer) {
+            throw std::logic_error(fmt::format(
+                "cannot remove fd {} while a coroutine is waiting for it",
+                fd
+            ));
+        }
+
+        if (it->second.events != 0) {
+            epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        }
+
+        watches.erase(it);
+    }
+
+    auto event_loop::run() -> void {
+        while (!empty()) run_once();
+    }
+
+    auto event_loop::run_once(std::chrono::milliseconds timeout)
+        -> std::size_t {
+        if (ready.empty() && waiting > 0) wait(timeout);
+        else if (waiting > 0) wait(std::chrono::milliseconds(0));
+
+        // Coroutines scheduled while this batch runs are resumed in the
+        // next pass. Each one is taken off the batch just before it runs,
+        // so that awaiters destroyed by earlier coroutines are never
+        // resumed.
+        batch.splice(ready);
+
+        auto count = std::size_t();
+
+        while (auto* const node = batch.pop()) {
+            ++count;
+            node->coroutine.resume();
+        }
+
+        return count;
+    }
+
+    auto event_loop::schedule() noexcept -> schedule_awaiter {
+        return schedule_awaiter(*this);
+    }
+
+    auto event_loop::sleep_for(clock::duration duration) noexcept
+        -> timer_awaiter {
+        return timer_awaiter(*this, clock::now() + duration);
+    }
+
+    auto event_loop::sleep_until(clock::time_point deadline) noexcept
+        -> timer_awaiter {
+        return timer_awaiter(*this, deadline);
+    }
+
+    auto event_loop::update(int fd, watch& w) -> void {
+        auto events = std::uint32_t();
+
+        if (options.edge_triggered) {
+            // Edge-triggered descriptors stay registered until removed.
+            if (w.events != 0) return;
+            events = edge_events;
+        }
+        else {
+            if (w.reader) events |= read_events;
+            if (w.writer) events |= write_events;
+        }
+
+        if (events == w.events) return;
+
+        auto event = epoll_event();
+        event.events = events;
+        event.data.fd = fd;
+
+        const auto op = w.events == 0 ? EPOLL_CTL_ADD
+                      : events == 0   ? EPOLL_CTL_DEL
+                                      : EPOLL_CTL_MOD;
+
+        if (epoll_ctl(epoll, op, fd, &event) == -1) {
+            throw ext::system_error(
+                fmt::format("failed to update epoll interest for fd {}", fd)
+            );
+        }
+
+        w.events = events;
+    }
+
+    auto event_loop::wait(std::chrono::milliseconds timeout) -> void {
+        if (!timers.empty()) {
+            const auto until_timer =
+                std::chrono::ceil<std::chrono::milliseconds>(
+                    timers.begin()->first - clock::now()
+                );
+            const auto limit = std::max(
+                until_timer,
+                std::chrono::milliseconds(0)
+            );
+
+            if (timeout.count() < 0 || limit < timeout) timeout = limit;
+        }
+
+        const auto count = epoll_wait(
+            epoll,
+            events.data(),
+            options.max_events,
+            static_cast<int>(timeout.count())
+        );
+
+        if (count == -1 && errno != EINTR) {
+            throw ext::system_error("failed to wait for events");
+        }
+
+        // Detach every awaiter in the batch before any coroutine runs, since
+        // a resumed coroutine may destroy other awaiters.
+        for (auto i = 0; i < count; ++i) {
+            const auto fd = events[i].data.fd;
+            const auto flags = events[i].events;
+            auto& w = watches.find(fd)->second;
+
+            const auto error = (flags & (EPOLLERR | EPOLLHUP)) != 0;
+            const auto awaiters = std::array<io_awaiter*, 2> {
+                (error || (flags & read_events)) ? w.reader : nullptr,
+                (error || (flags & write_events)) ? w.writer : nullptr
+            };
+
+            for (auto* const awaiter : awaiters) {
+                if (!awaiter) continue;
+
+                (awaiter->write ? w.writer : w.reader) = nullptr;
+                awaiter->registered = false;
+                --waiting;
+
+                ready.push(*awaiter);
+            }
+
+            update(fd, w);
+        }
+
+        const auto now = clock::now();
+
+        while (!timers.empty() && timers.begin()->first <= now) {
+            auto* const awaiter = timers.begin()->second;
+
+            timers.erase(timers.begin());
+            awaiter->registered = false;
+            --waiting;
+
+            ready.push(*awaiter);
+        }
+    }
+
+    auto event_loop::writable(int fd) noexcept -> io_awaiter {
+        return io_awaiter(*this, fd, true);
+    }
+}
@@ -0,0 +1,219 @@
+#include <ext/coroutine>
+#include <ext/event_loop>
+#include <ext/unix.h>
+
+#include <csignal>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+using namespace std::literals;
+
+TEST(EventLoop, Readable) {
+    auto loop = ext::event_loop();
+    auto pipe = ext::open_pipe();
+    auto received = std::string();
+
+    const auto reader = [&]() -> ext::detached_task {
+        co_await loop.readable(pipe.read.get());
+
+        auto buffer = std::array<char, 16>();
+        const auto bytes = read(pipe.read.get(), buffer.data(), buffer.size());
+        received.assign(buffer.data(), bytes);
+    };
+
+    const auto writer = [&]() -> ext::detached_task {
+        co_await loop.sleep_for(5ms);
+        co_await loop.writable(pipe.write.get());
+        write(pipe.write.get(), "hello", 5);
+    };
+
+    reader();
+    writer();
+
+    EXPECT_FALSE(loop.empty());
+    loop.run();
+    EXPECT_TRUE(loop.empty());
+
+    EXPECT_EQ("hello", received);
+}
+
+TEST(EventLoop, Schedule) {
+    auto loop = ext::event_loop();
+    auto order = std::string();
+
+    const auto worker = [&](char name) -> ext::detached_task {
+        for (auto i = 0; i < 3; ++i) {
+            co_await loop.schedule();
+            order.push_back(name);
+        }
+    };
+
+    worker('a');
+    worker('b');
+    loop.run();
+
+    EXPECT_EQ("ababab", order);
+}
+
+TEST(EventLoop, NoRecursion) {
+    auto loop = ext::event_loop();
+    auto count = 0;
+
+    // Resuming inline would overflow the stack.
+    const auto worker = [&]() -> ext::detached_task {
+        for (auto i = 0; i < 1'000'000; ++i) {
+            co_await loop.schedule();
+            ++count;
+        }
+    };
+
+    worker();
+    loop.run();
+
+    EXPECT_EQ(1'000'000, count);
+}
+
+TEST(EventLoop, DestroyReady) {
+    auto loop = ext::event_loop();
+    auto victim = std::optional<ext::jtask<>>();
+    auto resumed = false;
+
+    const auto target = [&]() -> ext::jtask<> {
+        co_await loop.schedule();
+        resumed = true;
+    };
+
+    // Both coroutines are ready in the same pass; the first one destroys
+    // the second before it runs.
+    const auto killer = [&]() -> ext::jtask<> {
+        co_await loop.schedule();
+        victim.reset();
+    };
+
+    auto task = killer();
+    victim.emplace(target());
+    loop.run();
+
+    EXPECT_TRUE(task.is_ready());
+    EXPECT_FALSE(resumed);
+    EXPECT_TRUE(loop.empty());
+}
+
+TEST(EventLoop, Timers) {
+    auto loop = ext::event_loop();
+    auto order = std::vector<int>();
+
+    const auto sleeper = [&](int ms) -> ext::detached_task {
+        co_await loop.sleep_for(std::chrono::milliseconds(ms));
+        order.push_back(ms);
+    };
+
+    sleeper(20);
+    sleeper(0);
+    sleeper(10);
+
+    const auto start = std::chrono::steady_clock::now();
+    loop.run();
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+    EXPECT_EQ((std::vector {0, 10, 20}), order);
+}
+
+TEST(EventLoop, RunUntil) {
+    auto loop = ext::event_loop();
+
+    const auto compute = [&]() -> ext::task<int> {
+        co_await loop.sleep_for(1ms);
+        co_return 42;
+    };
+
+    EXPECT_EQ(42, loop.run_until(compute()));
+}
+
+TEST(EventLoop, RunUntilException) {
+    auto loop = ext::event_loop();
+
+    const auto fail = [&]() -> ext::task<> {
+        co_await loop.schedule();
+        throw std::runtime_error("failure");
+    };
+
+    EXPECT_THROW(loop.run_until(fail()), std::runtime_error);
+}
+
+TEST(EventLoop, EdgeTriggered) {
+    auto loop = ext::event_loop({.edge_triggered = true});
+    auto pipe = ext::open_pipe();
+    auto reads = 0;
+
+    const auto reader = [&]() -> ext::task<> {
+        auto buffer = std::array<char, 16>();
+
+        for (auto i = 0; i < 2; ++i) {
+            co_await loop.readable(pipe.read.get());
+            read(pipe.read.get(), buffer.data(), buffer.size());
+            ++reads;
+        }
+
+        loop.remove(pipe.read.get());
+    };
+
+    const auto writer = [&]() -> ext::detached_task {
+        for (auto i = 0; i < 2; ++i) {
+            co_await loop.sleep_for(2ms);
+            write(pipe.write.get(), "x", 1);
+        }
+    };
+
+    writer();
+    loop.run_until(reader());
+
+    EXPECT_EQ(2, reads);
+}
+
+TEST(EventLoop, ProcessWait) {
+    auto loop = ext::event_loop();
+
+    const auto args = std::array {"-c"sv, "sleep 0.01; exit 7"sv};
+    const auto process = ext::spawn("sh", args);
+
+    const auto status = loop.run_until(process.async_wait(loop));
+
+    EXPECT_EQ(CLD_EXITED, status.code);
+    EXPECT_EQ(7, status.status);
+}
+
+TEST(EventLoop, ProcessWaitDestroyed) {
+    auto loop = ext::event_loop({.edge_triggered = true, .max_events = 64});
+    auto process = ext::spawn("sleep", std::array {"60"sv});
+
+    {
+        const auto wait = [&]() -> ext::jtask<> {
+            co_await process.async_wait(loop);
+        };
+
+        // Destroying the waiting task closes its pidfd, which must also be
+        // forgotten by the loop.
+        const auto task = wait();
+        EXPECT_FALSE(task.is_ready());
+    }
+
+    // The pipe likely reuses the pidfd's descriptor number.
+    auto pipe = ext::open_pipe();
+    auto received = false;
+
+    const auto reader = [&]() -> ext::detached_task {
+        co_await loop.readable(pipe.read.get());
+        received = true;
+    };
+
+    reader();
+    write(pipe.write.get(), "x", 1);
+
+    for (auto i = 0; i < 10 && !received; ++i) loop.run_once(10ms);
+
+    EXPECT_TRUE(received);
+
+    kill(process.pid(), SIGKILL);
+    process.wait();
+}
@@ -3,4 +3,7 @@
 namespace ext {
     system_error::system_error(const std::string& message) :
         std::system_error(errno, std::generic_category(), message) {}
+
+    system_error::system_error(std::error_code ec, const std::string& message) :
+        std::system_error(ec, message) {}
 }
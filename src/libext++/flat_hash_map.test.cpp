@@ -0,0 +1,162 @@
+#include <ext/flat_hash_map>
+#include <ext/string.h>
+
+#include <gtest/gtest.h>
+#include <unordered_map>
+
+using namespace std::literals;
+
+using ext::flat_hash_map;
+
+TEST(FlatHashMap, DefaultConstruction) {
+    const auto map = flat_hash_map<int, int>();
+
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(0, map.size());
+    EXPECT_EQ(0, map.capacity());
+    EXPECT_EQ(map.begin(), map.end());
+    EXPECT_FALSE(map.contains(1));
+}
+
+TEST(FlatHashMap, Insert) {
+    auto map = flat_hash_map<int, std::string>();
+
+    const auto [it, inserted] = map.insert({1, "one"});
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(1, it->first);
+    EXPECT_EQ("one", it->second);
+
+    EXPECT_FALSE(map.insert({1, "uno"}).second);
+    EXPECT_EQ("one", map.at(1));
+
+    map[2] = "two";
+    EXPECT_EQ(2, map.size());
+    EXPECT_EQ("two", map.at(2));
+
+    EXPECT_THROW(map.at(3), std::out_of_range);
+}
+
+TEST(FlatHashMap, InsertOrAssign) {
+    auto map = flat_hash_map<std::string, int>();
+
+    EXPECT_TRUE(map.insert_or_assign("foo", 1).second);
+    EXPECT_FALSE(map.insert_or_assign("foo", 2).second);
+    EXPECT_EQ(2, map.at("foo"));
+}
+
+TEST(FlatHashMap, Erase) {
+    auto map = flat_hash_map<int, int>();
+    for (auto i = 0; i < 100; ++i) map.emplace(i, i * i);
+
+    for (auto i = 0; i < 100; i += 2) EXPECT_EQ(1, map.erase(i));
+    EXPECT_EQ(0, map.erase(0));
+    EXPECT_EQ(50, map.size());
+
+    for (auto i = 0; i < 100; ++i) {
+        if (i % 2 == 0) EXPECT_FALSE(map.contains(i));
+        else EXPECT_EQ(i * i, map.at(i));
+    }
+}
+
+TEST(FlatHashMap, EraseWhileIterating) {
+    auto map = flat_hash_map<int, int>();
+    for (auto i = 0; i < 50; ++i) map.emplace(i, i);
+
+    for (auto it = map.begin(); it != map.end();) {
+        if (it->first % 3 == 0) it = map.erase(it);
+        else ++it;
+    }
+
+    EXPECT_EQ(33, map.size());
+    for (const auto& [key, value] : map) EXPECT_NE(0, key % 3);
+}
+
+TEST(FlatHashMap, MatchesUnorderedMap) {
+    auto map = flat_hash_map<std::uint64_t, std::uint64_t>();
+    auto reference = std::unordered_map<std::uint64_t, std::uint64_t>();
+    auto state = std::uint64_t(42);
+
+    for (auto i = 0; i < 20'000; ++i) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        const auto key = (state >> 33) % 2'000;
+
+        if (state & 1) {
+            map[key] = i;
+            reference[key] = i;
+        }
+        else EXPECT_EQ(reference.erase(key), map.erase(key));
+    }
+
+    ASSERT_EQ(reference.size(), map.size());
+
+    auto count = 0ul;
+    for (const auto& [key, value] : map) {
+        EXPECT_EQ(reference.at(key), value);
+        ++count;
+    }
+
+    EXPECT_EQ(reference.size(), count);
+}
+
+TEST(FlatHashMap, CopyAndMove) {
+    auto map = flat_hash_map<std::string, int> {{"a", 1}, {"b", 2}};
+
+    auto copy = map;
+    EXPECT_EQ(2, copy.size());
+    EXPECT_EQ(1, copy.at("a"));
+
+    auto moved = std::move(map);
+    EXPECT_EQ(2, moved.size());
+    EXPECT_TRUE(map.empty());
+
+    copy = moved;
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQ(2, copy.at("b"));
+}
+
+TEST(FlatHashMap, Reserve) {
+    auto map = flat_hash_map<int, int>();
+    map.reserve(100);
+
+    const auto capacity = map.capacity();
+    for (auto i = 0; i < 100; ++i) map.emplace(i, i);
+
+    EXPECT_EQ(capacity, map.capacity());
+}
+
+TEST(FlatHashMap, HeterogeneousLookup) {
+    auto map = ext::flat_string_map();
+    map.try_emplace("key"sv, "value");
+
+    constexpr auto key = "key"sv;
+
+    EXPECT_TRUE(map.contains(key));
+    EXPECT_EQ("value", map.find(key)->second);
+    EXPECT_EQ(1, map.erase(key));
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(StringMap, HeterogeneousLookup) {
+    auto map = ext::string_map {{"key", "value"}};
+
+    EXPECT_TRUE(map.contains("key"sv));
+    EXPECT_EQ("value", map.find("key"sv)->second);
+}
+
+TEST(Hash, Bytes) {
+    const auto string = std::string(100, 'x');
+
+    for (auto size = 0ul; size <= string.size(); ++size) {
+        const auto view = std::string_view(string).substr(0, size);
+        const auto copy = std::string(view);
+
+        EXPECT_EQ(ext::string_hash()(view), ext::string_hash()(copy));
+        if (size > 0) {
+            EXPECT_NE(
+                ext::string_hash()(view),
+                ext::string_hash()(view.substr(1))
+            );
+        }
+    }
+}
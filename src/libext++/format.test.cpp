@@ -0,0 +1,69 @@
+#include <ext/chrono.h>
+#include <ext/data_size.h>
+#include <ext/string.h>
+#include <ext/unix.h>
+
+#include <gtest/gtest.h>
+
+using namespace ext::literals;
+
+TEST(Format, ByteMultiple) {
+    EXPECT_EQ("KiB", fmt::format("{}", ext::byte_multiple::KiB));
+    EXPECT_EQ("  B", fmt::format("{:>3}", ext::byte_multiple::B));
+}
+
+TEST(Format, DataSize) {
+    const auto size = ext::data_size::format(1536);
+
+    EXPECT_EQ("1.5 KiB", fmt::format("{}", size));
+    EXPECT_EQ("2 KiB", fmt::format("{:.0}", size));
+    EXPECT_EQ("1536 B", fmt::format("{:B}", size));
+    EXPECT_EQ("0.002 MiB", fmt::format("{:.3MiB}", size));
+    EXPECT_EQ(size.str(2), fmt::format("{:.2}", size));
+}
+
+TEST(Format, DataSizeLarge) {
+    const auto size = ext::data_size::format(5_GiB);
+
+    EXPECT_EQ("5 GiB", fmt::format("{}", size));
+    EXPECT_EQ("5242880 KiB", fmt::format("{:KiB}", size));
+}
+
+TEST(Format, ExitStatus) {
+    EXPECT_EQ(
+        "exited with status 3",
+        fmt::format("{}", ext::exit_status {.code = CLD_EXITED, .status = 3})
+    );
+    EXPECT_EQ(
+        "killed by signal 9",
+        fmt::format("{}", ext::exit_status {.code = CLD_KILLED, .status = 9})
+    );
+}
+
+TEST(Format, Quoted) {
+    EXPECT_EQ("‘foo bar‘", fmt::format("{}", ext::quoted("foo bar")));
+    EXPECT_EQ("‘foo bar‘", ext::quote("foo bar"));
+}
+
+TEST(Format, Timestamp) {
+    const auto ts = ext::chrono::timestamp("%Y-%m-%d", ext::chrono::gmt);
+    const auto formatted = fmt::format("{}", ts);
+
+    EXPECT_EQ(10, formatted.size());
+    EXPECT_EQ(ts.strftime(32), formatted);
+
+    auto os = std::ostringstream();
+    os << ts;
+    EXPECT_EQ(formatted, os.str());
+}
+
+TEST(Format, TimestampLong) {
+    auto spec = std::string();
+    for (auto i = 0; i < 100; ++i) spec.append("%Y ");
+
+    const auto ts = ext::chrono::timestamp(spec, ext::chrono::gmt);
+
+    // The output outgrows the initial buffer, and its trailing space is
+    // kept.
+    EXPECT_EQ(500, fmt::format("{}", ts).size());
+}
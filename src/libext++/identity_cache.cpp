@@ -0,0 +1,80 @@
+#include <ext/identity_cache>
+
+#include <type_traits>
+
+namespace {
+    auto id_of(const ext::group& group) -> gid_t { return group.gid(); }
+
+    auto id_of(const ext::user& user) -> uid_t { return user.uid(); }
+
+    template <typename T, typename Id, typename Key>
+    auto fetch(
+        ext::detail::identity_table<T, Id>& table,
+        const Key& key,
+        const ext::identity_cache_options& options
+    ) -> std::shared_ptr<const T> {
+        using clock = std::chrono::steady_clock;
+
+        if (auto cached = table.find(key, clock::now())) return *cached;
+
+        auto entry = std::optional<T>();
+
+        if constexpr (std::is_same_v<Key, std::string_view>) {
+            entry = T::lookup(std::string(key));
+        }
+        else entry = T::lookup(key);
+
+        // The lookup may have taken a while, so the entry's lifetime starts
+        // once it is known.
+        const auto now = clock::now();
+
+        if (!entry) {
+            table.store_missing(key, now, now + options.negative_ttl);
+            return nullptr;
+        }
+
+        auto result = std::make_shared<const T>(std::move(*entry));
+
+        table.store(
+            id_of(*result),
+            result->name(),
+            result,
+            now,
+            now + options.ttl
+        );
+
+        return result;
+    }
+}
+
+namespace ext {
+    identity_cache::identity_cache(identity_cache_options options) :
+        options(options),
+        groups(options.max_missing),
+        users(options.max_missing) {}
+
+    auto identity_cache::clear() -> void {
+        groups.clear();
+        users.clear();
+    }
+
+    auto identity_cache::find_group(gid_t gid)
+        -> std::shared_ptr<const ext::group> {
+        return fetch(groups, gid, options);
+    }
+
+    auto identity_cache::find_group(std::string_view name)
+        -> std::shared_ptr<const ext::group> {
+        return fetch(groups, name, options);
+    }
+
+    auto identity_cache::find_user(uid_t uid)
+        -> std::shared_ptr<const ext::user> {
+        return fetch(users, uid, options);
+    }
+
+    auto identity_cache::find_user(std::string_view name)
+        -> std::shared_ptr<const ext::user> {
+        return fetch(users, name, options);
+    }
+}
@@ -0,0 +1,156 @@
+#include <ext/identity_cache>
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+    constexpr auto missing_id = 0x7ffffff0;
+    constexpr auto missing_name = "ext-identity-cache-test-missing"sv;
+}
+
+TEST(IdentityCache, FindUser) {
+    auto cache = ext::identity_cache();
+
+    const auto by_id = cache.find_user(getuid());
+    ASSERT_TRUE(by_id);
+    EXPECT_EQ(getuid(), by_id->uid());
+
+    const auto name = std::string(by_id->name());
+    const auto by_name = cache.find_user(name);
+
+    EXPECT_EQ(by_id, by_name);
+    EXPECT_EQ(by_id, cache.find_user(getuid()));
+}
+
+TEST(IdentityCache, FindGroup) {
+    auto cache = ext::identity_cache();
+
+    const auto by_id = cache.find_group(getgid());
+    ASSERT_TRUE(by_id);
+    EXPECT_EQ(getgid(), by_id->gid());
+
+    const auto name = std::string(by_id->name());
+    EXPECT_EQ(by_id, cache.find_group(name));
+}
+
+TEST(IdentityCache, Missing) {
+    auto cache = ext::identity_cache();
+
+    EXPECT_FALSE(cache.find_user(missing_id));
+    EXPECT_FALSE(cache.find_user(missing_name));
+    EXPECT_FALSE(cache.find_group(missing_id));
+    EXPECT_FALSE(cache.find_group(missing_name));
+
+    // Negative results are cached too.
+    EXPECT_FALSE(cache.find_user(missing_id));
+    EXPECT_FALSE(cache.find_group(missing_name));
+}
+
+TEST(IdentityCache, Expiry) {
+    auto cache = ext::identity_cache({.ttl = 0s, .negative_ttl = 0s});
+
+    const auto first = cache.find_user(getuid());
+    const auto second = cache.find_user(getuid());
+
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(first->name(), second->name());
+}
+
+TEST(IdentityCache, Clear) {
+    auto cache = ext::identity_cache();
+
+    const auto first = cache.find_group(getgid());
+    cache.clear();
+
+    EXPECT_NE(first, cache.find_group(getgid()));
+}
+
+TEST(IdentityCache, Concurrent) {
+    auto cache = ext::identity_cache();
+    auto threads = std::vector<std::jthread>();
+
+    for (auto i = 0; i < 4; ++i) {
+        threads.emplace_back([&cache] {
+            for (auto j = 0; j < 100; ++j) {
+                const auto user = cache.find_user(getuid());
+                ASSERT_TRUE(user);
+                EXPECT_EQ(getuid(), user->uid());
+            }
+        });
+    }
+}
+
+TEST(IdentityTable, MissingLimit) {
+    using table_type = ext::detail::identity_table<std::string, int>;
+
+    auto table = table_type(4);
+    const auto now = table_type::clock::now();
+
+    for (auto i = 0; i < 100; ++i) {
+        table.store_missing(i, now, now + 1h);
+        table.store_missing(std::to_string(i), now, now + 1h);
+    }
+
+    EXPECT_EQ(8, table.size());
+
+    // The oldest entries are evicted first.
+    EXPECT_FALSE(table.find(95, now));
+    EXPECT_EQ(nullptr, table.find(96, now));
+    EXPECT_EQ(nullptr, table.find("99"sv, now));
+}
+
+TEST(IdentityTable, Expired) {
+    using table_type = ext::detail::identity_table<std::string, int>;
+
+    auto table = table_type(1024);
+    const auto now = table_type::clock::now();
+
+    // Expired entries for missing keys are evicted as new ones arrive.
+    for (auto i = 0; i < 100; ++i) {
+        const auto time = now + std::chrono::seconds(i);
+        table.store_missing(i, time, time + 1s);
+    }
+
+    EXPECT_EQ(1, table.size());
+
+    // Expired entries under keys that are not looked up again are swept
+    // out as the table grows.
+    for (auto i = 0; i < 1000; ++i) {
+        const auto time = now + std::chrono::seconds(i);
+        const auto value = std::make_shared<const std::string>("entry");
+
+        table.store(i + 1000, std::to_string(i), value, time, time + 1s);
+    }
+
+    EXPECT_LT(table.size(), 200);
+}
+
+TEST(UserLookup, Missing) {
+    EXPECT_FALSE(ext::user::lookup(uid_t(missing_id)));
+    EXPECT_FALSE(ext::group::lookup(std::string(missing_name)));
+
+    const auto root = ext::user::lookup(uid_t(0));
+    ASSERT_TRUE(root);
+    EXPECT_EQ("root"sv, root->name());
+}
+
+TEST(UserLookup, ErrorCode) {
+    auto ec = std::make_error_code(std::errc::io_error);
+
+    const auto root = ext::user::lookup(uid_t(0), ec);
+    EXPECT_FALSE(ec);
+    ASSERT_TRUE(root);
+    EXPECT_EQ(0, root->uid());
+
+    EXPECT_FALSE(ext::user::lookup(std::string(missing_name), ec));
+    EXPECT_FALSE(ec);
+
+    EXPECT_FALSE(ext::group::lookup(gid_t(missing_id), ec));
+    EXPECT_FALSE(ec);
+}
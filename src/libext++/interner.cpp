@@ -0,0 +1,161 @@
+#include <ext/detail/interner.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <fmt/format.h>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace ext {
+    interner::interner(std::uint64_t max_size) :
+        limit(std::min(max_size, max_symbols)) {}
+
+    auto interner::operator[](symbol sym) const noexcept -> std::string_view {
+        return strings[static_cast<std::size_t>(sym)];
+    }
+
+    auto interner::contains(std::string_view string) const -> bool {
+        return symbols.contains(string);
+    }
+
+    auto interner::find(std::string_view string) const
+        -> std::optional<symbol> {
+        if (const auto it = symbols.find(string); it != symbols.end()) {
+            return it->second;
+        }
+
+        return std::nullopt;
+    }
+
+    auto interner::intern(std::string_view string) -> symbol {
+        if (const auto it = symbols.find(string); it != symbols.end()) {
+            return it->second;
+        }
+
+        if (strings.size() == limit) {
+            throw std::length_error("interner is full");
+        }
+
+        const auto copy = storage.copy(string);
+        const auto sym = static_cast<symbol>(strings.size());
+
+        strings.push_back(copy);
+        symbols.emplace(copy, sym);
+
+        return sym;
+    }
+
+    auto interner::intern_view(std::string_view string) -> std::string_view {
+        return (*this)[intern(string)];
+    }
+
+    auto interner::max_size() const noexcept -> std::uint64_t {
+        return limit;
+    }
+
+    auto interner::size() const noexcept -> std::size_t {
+        return strings.size();
+    }
+
+    sharded_interner::sharded_interner(std::size_t shard_count) :
+        shard_bits(std::bit_width(std::max(shard_count, std::size_t(1)) - 1)) {
+        if (int(shard_bits) >= std::countr_zero(interner::max_symbols)) {
+            throw std::invalid_argument(fmt::format(
+                "too many shards for an interner: {}",
+                shard_count
+            ));
+        }
+
+        shards = std::unique_ptr<shard[]>(new shard[this->shard_count()]);
+
+        // Symbols keep 'shard_bits' bits for the shard, leaving the rest
+        // for the string's index within it.
+        const auto per_shard = interner::max_symbols >> shard_bits;
+
+        for (auto i = std::size_t(); i < this->shard_count(); ++i) {
+            shards[i].strings = interner(per_shard);
+        }
+    }
+
+    auto sharded_interner::shard_for(std::string_view string) const noexcept
+        -> std::size_t {
+        const auto hash = string_hash()(string);
+
+        // The shard's own table multiplies the same hash by an odd constant
+        // and takes each key's tag from the low bits of the product, which
+        // depend only on the low bits of the hash. Pick the shard from the
+        // high bits, so that keys within a shard still differ in their tags.
+        constexpr auto digits = std::numeric_limits<std::size_t>::digits;
+        return shard_bits == 0 ? 0 : hash >> (digits - shard_bits);
+    }
+
+    auto sharded_interner::operator[](symbol sym) const -> std::string_view {
+        const auto value = static_cast<std::uint32_t>(sym);
+        const auto& shard = shards[value & ((1u << shard_bits) - 1)];
+
+        const auto lock = std::shared_lock(shard.mutex);
+        return shard.strings[static_cast<symbol>(value >> shard_bits)];
+    }
+
+    auto sharded_interner::contains(std::string_view string) const -> bool {
+        return find(string).has_value();
+    }
+
+    auto sharded_interner::find(std::string_view string) const
+        -> std::optional<symbol> {
+        const auto index = shard_for(string);
+        const auto& shard = shards[index];
+
+        const auto lock = std::shared_lock(shard.mutex);
+
+        if (const auto local = shard.strings.find(string)) {
+            return static_cast<symbol>(
+                (static_cast<std::uint32_t>(*local) << shard_bits) | index
+            );
+        }
+
+        return std::nullopt;
+    }
+
+    auto sharded_interner::intern(std::string_view string) -> symbol {
+        const auto index = shard_for(string);
+        auto& shard = shards[index];
+
+        const auto encode = [this, index](symbol local) -> symbol {
+            return static_cast<symbol>(
+                (static_cast<std::uint32_t>(local) << shard_bits) | index
+            );
+        };
+
+        {
+            const auto lock = std::shared_lock(shard.mutex);
+            if (const auto local = shard.strings.find(string)) {
+                return encode(*local);
+            }
+        }
+
+        const auto lock = std::unique_lock(shard.mutex);
+        return encode(shard.strings.intern(string));
+    }
+
+    auto sharded_interner::intern_view(std::string_view string)
+        -> std::string_view {
+        return (*this)[intern(string)];
+    }
+
+    auto sharded_interner::shard_count() const noexcept -> std::size_t {
+        return std::size_t(1) << shard_bits;
+    }
+
+    auto sharded_interner::size() const -> std::size_t {
+        auto result = std::size_t(0);
+
+        for (auto i = std::size_t(); i < shard_count(); ++i) {
+            const auto lock = std::shared_lock(shards[i].mutex);
+            result += shards[i].strings.size();
+        }
+
+        return result;
+    }
+}
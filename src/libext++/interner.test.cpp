@@ -0,0 +1,118 @@
+#include <ext/interner>
+
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std::literals;
+
+TEST(Arena, Copy) {
+    auto arena = ext::arena(16);
+
+    const auto foo = arena.copy("foo");
+    const auto long_string = arena.copy(std::string(100, 'x'));
+    const auto bar = arena.copy("bar"s);
+
+    EXPECT_EQ("foo"sv, foo);
+    EXPECT_EQ(std::string(100, 'x'), long_string);
+    EXPECT_EQ("bar"sv, bar);
+    EXPECT_EQ('\0', foo.data()[foo.size()]);
+    EXPECT_EQ(109, arena.size());
+}
+
+TEST(Arena, Alignment) {
+    auto arena = ext::arena();
+
+    arena.allocate(1, 1);
+    const auto* const aligned = arena.allocate(8, 8);
+
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(aligned) % 8);
+}
+
+TEST(Interner, Intern) {
+    auto strings = ext::interner();
+
+    const auto foo = strings.intern("foo");
+    const auto bar = strings.intern("bar"s);
+
+    EXPECT_NE(foo, bar);
+    EXPECT_EQ(foo, strings.intern("foo"sv));
+    EXPECT_EQ(2, strings.size());
+
+    EXPECT_EQ("foo"sv, strings[foo]);
+    EXPECT_EQ("bar"sv, strings[bar]);
+}
+
+TEST(Interner, StableViews) {
+    auto strings = ext::interner();
+    const auto first = strings.intern_view("first");
+
+    for (auto i = 0; i < 1'000; ++i) strings.intern(std::to_string(i));
+
+    EXPECT_EQ(first.data(), strings.intern_view("first").data());
+    EXPECT_EQ("first"sv, first);
+}
+
+TEST(Interner, Find) {
+    auto strings = ext::interner();
+    const auto foo = strings.intern("foo");
+
+    EXPECT_EQ(foo, strings.find("foo"));
+    EXPECT_FALSE(strings.find("bar").has_value());
+    EXPECT_TRUE(strings.contains("foo"));
+    EXPECT_FALSE(strings.contains("bar"));
+}
+
+TEST(Interner, Full) {
+    auto strings = ext::interner(2);
+
+    const auto foo = strings.intern("foo");
+    const auto bar = strings.intern("bar");
+
+    EXPECT_EQ(2, strings.max_size());
+    EXPECT_THROW(strings.intern("baz"), std::length_error);
+
+    // Strings already present can still be interned.
+    EXPECT_EQ(foo, strings.intern("foo"));
+    EXPECT_EQ(bar, strings.intern("bar"));
+    EXPECT_EQ(2, strings.size());
+}
+
+TEST(ShardedInterner, ShardCount) {
+    EXPECT_EQ(1, ext::sharded_interner(1).shard_count());
+    EXPECT_EQ(8, ext::sharded_interner(5).shard_count());
+    EXPECT_EQ(16, ext::sharded_interner().shard_count());
+
+    // Every shard must have room for more than one string.
+    EXPECT_THROW(
+        ext::sharded_interner(std::size_t(1) << 32),
+        std::invalid_argument
+    );
+}
+
+TEST(ShardedInterner, Concurrent) {
+    constexpr auto thread_count = 4;
+    constexpr auto string_count = 1'000;
+
+    auto strings = ext::sharded_interner();
+    auto symbols = std::vector<std::vector<ext::symbol>>(thread_count);
+    auto threads = std::vector<std::thread>();
+
+    for (auto t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            for (auto i = 0; i < string_count; ++i) {
+                symbols[t].push_back(strings.intern(std::to_string(i)));
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(string_count, strings.size());
+
+    for (auto i = 0; i < string_count; ++i) {
+        const auto sym = symbols[0][i];
+
+        EXPECT_EQ(std::to_string(i), strings[sym]);
+        for (const auto& other : symbols) EXPECT_EQ(sym, other[i]);
+    }
+}
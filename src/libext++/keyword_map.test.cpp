@@ -0,0 +1,84 @@
+#include <ext/chrono.h>
+#include <ext/data_size.h>
+#include <ext/keyword_map>
+
+#include <gtest/gtest.h>
+
+namespace {
+    enum class command { get, set, del, incr, decr, keys, ping, quit };
+
+    constexpr auto commands = ext::make_keyword_map<command>({
+        {"GET", command::get},
+        {"SET", command::set},
+        {"DEL", command::del},
+        {"INCR", command::incr},
+        {"DECR", command::decr},
+        {"KEYS", command::keys},
+        {"PING", command::ping},
+        {"QUIT", command::quit},
+    });
+}
+
+static_assert(commands.find("INCR") == command::incr);
+static_assert(!commands.contains("incr"));
+
+TEST(KeywordMap, Find) {
+    for (const auto& [key, value] : commands) {
+        EXPECT_EQ(value, commands.find(key));
+    }
+
+    EXPECT_EQ(8, commands.size());
+    EXPECT_FALSE(commands.find(""));
+    EXPECT_FALSE(commands.find("GETS"));
+    EXPECT_FALSE(commands.find("get"));
+}
+
+TEST(KeywordMap, Large) {
+    static constexpr auto numbers = ext::make_keyword_map<int>({
+        {"zero", 0},
+        {"one", 1},
+        {"two", 2},
+        {"three", 3},
+        {"four", 4},
+        {"five", 5},
+        {"six", 6},
+        {"seven", 7},
+        {"eight", 8},
+        {"nine", 9},
+        {"ten", 10},
+        {"eleven", 11},
+        {"twelve", 12},
+        {"thirteen", 13},
+        {"fourteen", 14},
+        {"fifteen", 15},
+        {"sixteen", 16},
+        {"seventeen", 17},
+        {"eighteen", 18},
+        {"nineteen", 19},
+        {"twenty", 20},
+    });
+
+    for (const auto& [key, value] : numbers) {
+        EXPECT_EQ(value, numbers.find(key)) << key;
+    }
+
+    EXPECT_FALSE(numbers.contains("twentyone"));
+}
+
+TEST(KeywordMap, Runtime) {
+    const auto map = ext::make_keyword_map<int>({{"a", 1}, {"b", 2}});
+
+    EXPECT_EQ(2, map.find("b"));
+    EXPECT_THROW(
+        ext::make_keyword_map<int>({{"a", 1}, {"a", 2}}),
+        std::invalid_argument
+    );
+}
+
+TEST(KeywordMap, LibraryKeywords) {
+    EXPECT_EQ(ext::byte_multiple::MiB, ext::parse_byte_multiple("MiB"));
+    EXPECT_FALSE(ext::parse_byte_multiple("MB"));
+
+    EXPECT_EQ(ext::chrono::local, ext::chrono::parse_time_type("local"));
+    EXPECT_FALSE(ext::chrono::parse_time_type("utc"));
+}
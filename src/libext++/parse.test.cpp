@@ -0,0 +1,106 @@
+#include <ext/parse>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+TEST(Parse, Integer) {
+    EXPECT_EQ(42, ext::parse<int>("42").value());
+    EXPECT_EQ(-7, *ext::parse<long>("-7"));
+    EXPECT_EQ(255, ext::parse<std::uint8_t>("255").value());
+
+    EXPECT_EQ(
+        std::errc::result_out_of_range,
+        ext::parse<std::uint8_t>("256").error()
+    );
+    EXPECT_EQ(std::errc::invalid_argument, ext::parse<int>("").error());
+    EXPECT_EQ(std::errc::invalid_argument, ext::parse<int>(" 1").error());
+    EXPECT_EQ(std::errc::invalid_argument, ext::parse<int>("12ab").error());
+}
+
+TEST(Parse, Floating) {
+    EXPECT_DOUBLE_EQ(3.25, ext::parse<double>("3.25").value());
+    EXPECT_DOUBLE_EQ(-1e-3, ext::parse<double>("-1e-3").value());
+    EXPECT_FALSE(ext::parse<double>("1.5x"));
+}
+
+TEST(Parse, Bool) {
+    EXPECT_TRUE(ext::parse<bool>("true").value());
+    EXPECT_TRUE(ext::parse<bool>("1").value());
+    EXPECT_FALSE(ext::parse<bool>("false").value());
+    EXPECT_FALSE(ext::parse<bool>("0").value());
+    EXPECT_FALSE(ext::parse<bool>("yes").has_value());
+}
+
+TEST(Parse, Error) {
+    const auto result = ext::parse<int>("x");
+
+    EXPECT_FALSE(result);
+    EXPECT_EQ(5, result.value_or(5));
+    EXPECT_THROW(result.value(), std::system_error);
+}
+
+TEST(SplitParse, Tuple) {
+    const auto result =
+        ext::split_parse<int, std::string_view, double>("1, two, 3.5", ", ");
+
+    ASSERT_TRUE(result);
+    EXPECT_EQ(std::make_tuple(1, "two"sv, 3.5), *result);
+}
+
+TEST(SplitParse, FieldCount) {
+    EXPECT_EQ(
+        std::errc::invalid_argument,
+        (ext::split_parse<int, int>("1,2,3", ",").error())
+    );
+    EXPECT_EQ(
+        std::errc::invalid_argument,
+        (ext::split_parse<int, int>("1", ",").error())
+    );
+}
+
+TEST(SplitParse, Struct) {
+    struct point {
+        int x;
+        int y;
+        std::string label;
+
+        point(int x, int y, std::string label) :
+            x(x),
+            y(y),
+            label(std::move(label)) {}
+    };
+
+    const auto result = ext::split_parse_as<point, int, int, std::string>(
+        "3\t-4\torigin",
+        "\t"
+    );
+
+    ASSERT_TRUE(result);
+    EXPECT_EQ(3, result->x);
+    EXPECT_EQ(-4, result->y);
+    EXPECT_EQ("origin", result->label);
+}
+
+TEST(SplitParse, Columns) {
+    auto ids = ext::dynarray<int>(2);
+    auto scores = ext::dynarray<double>(2);
+
+    EXPECT_EQ(std::errc(), ext::split_parse_into("1,0.5", ",", ids, scores));
+    EXPECT_EQ(
+        std::errc::invalid_argument,
+        ext::split_parse_into("2,bad", ",", ids, scores)
+    );
+    EXPECT_EQ(1, ids.size());
+    EXPECT_EQ(1, scores.size());
+
+    EXPECT_EQ(std::errc(), ext::split_parse_into("2,1.5", ",", ids, scores));
+    EXPECT_EQ(
+        std::errc::no_buffer_space,
+        ext::split_parse_into("3,2.5", ",", ids, scores)
+    );
+
+    ASSERT_EQ(2, ids.size());
+    EXPECT_EQ(2, ids[1]);
+    EXPECT_DOUBLE_EQ(1.5, scores[1]);
+}
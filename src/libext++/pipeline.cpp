@@ -0,0 +1,173 @@
+#include <ext/pipeline>
+#include <ext/except.h>
+
+#include <csignal>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <span>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+    /**
+     * Waits for every process, ignoring errors, so that none is left
+     * unreaped after a failure.
+     */
+    auto reap(std::span<const ext::process> processes) noexcept -> void {
+        for (const auto& process : processes) {
+            auto ec = std::error_code();
+            process.wait(ec);
+        }
+    }
+}
+
+namespace ext {
+    auto pipeline::add(
+        std::string_view program,
+        std::span<const std::string_view> args,
+        spawn_options options
+    ) -> pipeline& {
+        stages.push_back({
+            .program = std::string(program),
+            .args = std::vector<std::string>(args.begin(), args.end()),
+            .options = std::move(options)
+        });
+
+        return *this;
+    }
+
+    auto pipeline::pipe_size(int size) -> pipeline& {
+        buffer_size = size;
+        return *this;
+    }
+
+    auto pipeline::run() const -> std::vector<exit_status> {
+        const auto processes = start();
+
+        auto result = std::vector<exit_status>();
+        result.reserve(processes.size());
+
+        for (auto i = std::size_t(); i < processes.size(); ++i) {
+            try {
+                result.push_back(processes[i].wait());
+            }
+            catch (...) {
+                reap(std::span(processes).subspan(i + 1));
+                throw;
+            }
+        }
+
+        return result;
+    }
+
+    auto pipeline::run(resource_usage& total) const
+        -> std::vector<exit_status> {
+        const auto processes = start();
+
+        auto result = std::vector<exit_status>();
+        result.reserve(processes.size());
+
+        for (auto i = std::size_t(); i < processes.size(); ++i) {
+            auto usage = resource_usage();
+
+            try {
+                result.push_back(processes[i].wait(usage));
+            }
+            catch (...) {
+                reap(std::span(processes).subspan(i + 1));
+                throw;
+            }
+
+            total += usage;
+        }
+
+        return result;
+    }
+
+    auto pipeline::size() const noexcept -> std::size_t {
+        return stages.size();
+    }
+
+    auto pipeline::start() const -> std::vector<process> {
+        if (stages.empty()) {
+            throw std::logic_error("pipeline has no stages");
+        }
+
+        auto processes = std::vector<process>();
+        processes.reserve(stages.size());
+
+        // The read end of the pipe feeding the next stage.
+        auto input = unique_fd();
+
+        try {
+            for (auto i = 0ul; i < stages.size(); ++i) {
+                const auto& stage = stages[i];
+                const auto last = i == stages.size() - 1;
+
+                auto options = stage.options;
+                auto output = pipe_fds();
+
+                if (input) {
+                    options.in = stdio::inherit;
+                    options.fds.insert(
+                        options.fds.begin(),
+                        fd_mapping {
+                            .child = STDIN_FILENO,
+                            .parent = input.get()
+                        }
+                    );
+                }
+
+                if (!last) {
+                    output = open_pipe();
+
+                    if (buffer_size) {
+                        const auto fd = output.write.get();
+
+                        if (fcntl(fd, F_SETPIPE_SZ, *buffer_size) == -1) {
+                            throw system_error(fmt::format(
+                                "failed to set pipe size to {}",
+                                *buffer_size
+                            ));
+                        }
+                    }
+
+                    options.out = stdio::inherit;
+                    options.fds.insert(
+                        options.fds.begin(),
+                        fd_mapping {
+                            .child = STDOUT_FILENO,
+                            .parent = output.write.get()
+                        }
+                    );
+                }
+
+                const auto args = std::vector<std::string_view>(
+                    stage.args.begin(),
+                    stage.args.end()
+                );
+
+                processes.push_back(spawn(stage.program, args, options));
+
+                // Only the stages may hold the pipe ends, or readers would
+                // never see the end of their input.
+                input = std::move(output.read);
+            }
+        }
+        catch (...) {
+            // The stages already started may be waiting for input that will
+            // never arrive, so stop them before reaping them.
+            input.reset();
+
+            for (const auto& process : processes) {
+                ::kill(process.pid(), SIGKILL);
+            }
+
+            reap(processes);
+
+            throw;
+        }
+
+        return processes;
+    }
+}
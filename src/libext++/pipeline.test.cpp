@@ -0,0 +1,131 @@
+#include <ext/pipeline>
+
+#include <csignal>
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+namespace {
+    auto exited(int status) -> ext::exit_status {
+        return {.code = CLD_EXITED, .status = status};
+    }
+
+    auto read_all(ext::unique_fd& fd) -> std::string {
+        auto reader = ext::fd_reader(fd.get());
+        auto result = std::string();
+
+        for (auto chunk = reader.read(); !chunk.empty();
+             chunk = reader.read()) {
+            result.append(chunk);
+        }
+
+        return result;
+    }
+}
+
+TEST(Pipeline, ExitStatus) {
+    const auto statuses =
+        ext::pipeline()("true")("false")("sh", "-c", "exit 3").run();
+
+    EXPECT_EQ(
+        (std::vector {exited(0), exited(1), exited(3)}),
+        statuses
+    );
+}
+
+TEST(Pipeline, Output) {
+    auto pipeline = ext::pipeline();
+    const auto sort = std::array {"-r"sv};
+
+    auto options = ext::spawn_options();
+    options.out = ext::stdio::pipe;
+
+    pipeline("printf", "a\\nb\\nc\\n")("tr", "a-z", "A-Z")
+        .add("sort", sort, options);
+
+    EXPECT_EQ(3, pipeline.size());
+
+    auto processes = pipeline.start();
+
+    EXPECT_EQ("C\nB\nA\n", read_all(processes.back().stdout_fd()));
+
+    for (const auto& process : processes) {
+        EXPECT_EQ(exited(0), process.wait());
+    }
+}
+
+TEST(Pipeline, Input) {
+    auto pipeline = ext::pipeline();
+    const auto cat = std::span<const std::string_view>();
+
+    auto input = ext::spawn_options();
+    input.in = ext::stdio::pipe;
+
+    auto output = ext::spawn_options();
+    output.out = ext::stdio::pipe;
+
+    pipeline.add("cat", cat, input).add("wc", std::array {"-c"sv}, output);
+
+    auto processes = pipeline.start();
+
+    auto& in = processes.front().stdin_fd();
+    ASSERT_EQ(5, write(in.get(), "hello", 5));
+    in.reset();
+
+    EXPECT_EQ("5", ext::trim(read_all(processes.back().stdout_fd())));
+}
+
+TEST(Pipeline, Concurrent) {
+    auto pipeline = ext::pipeline();
+    const auto head = std::array {"-n"sv, "1000"sv};
+
+    // 'yes' never finishes on its own: it stops only when 'head' exits and
+    // closes the pipe.
+    auto options = ext::spawn_options();
+    options.out = ext::stdio::null;
+
+    pipeline.pipe_size(128 * 1024)("yes").add("head", head, options);
+
+    const auto statuses = pipeline.run();
+
+    ASSERT_EQ(2, statuses.size());
+    EXPECT_EQ(CLD_KILLED, statuses[0].code);
+    EXPECT_EQ(SIGPIPE, statuses[0].status);
+    EXPECT_EQ(exited(0), statuses[1]);
+}
+
+TEST(Pipeline, ResourceUsage) {
+    auto total = ext::resource_usage();
+    const auto statuses = ext::pipeline()("true")("true").run(total);
+
+    auto single = ext::resource_usage();
+    ext::spawn("true", {}).wait(single);
+
+    EXPECT_EQ((std::vector {exited(0), exited(0)}), statuses);
+    EXPECT_GE(total.minor_faults, single.minor_faults);
+    EXPECT_GT(total.max_rss, 0);
+}
+
+TEST(Pipeline, MissingProgram) {
+    EXPECT_THROW(
+        ext::pipeline()("true")("ext-pipeline-missing").run(),
+        std::exception
+    );
+}
+
+TEST(Pipeline, MissingLastProgram) {
+    const auto start = std::chrono::steady_clock::now();
+
+    // The first stage must be stopped, or it would run to completion
+    // before the error is reported.
+    EXPECT_THROW(
+        ext::pipeline()("sleep", "60")("ext-pipeline-missing").run(),
+        std::exception
+    );
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 10s);
+}
+
+TEST(Pipeline, Empty) {
+    EXPECT_THROW(ext::pipeline().run(), std::logic_error);
+}
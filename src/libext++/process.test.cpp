@@ -0,0 +1,456 @@
+#include <ext/child_monitor>
+#include <ext/coroutine>
+#include <ext/unix.h>
+
+#include <csignal>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::literals;
+
+namespace {
+    auto sh(std::string_view script, const ext::spawn_options& options = {})
+        -> ext::exit_status {
+        const auto args = std::array {"-c"sv, script};
+        return ext::spawn("sh", args, options).wait();
+    }
+
+    auto exited(int status) -> ext::exit_status {
+        return {.code = CLD_EXITED, .status = status};
+    }
+}
+
+TEST(Process, ExitStatus) {
+    EXPECT_EQ(exited(0), ext::$("true"));
+    EXPECT_EQ(exited(1), ext::$("false"));
+    EXPECT_EQ(exited(3), sh("exit 3"));
+}
+
+TEST(Process, Arguments) {
+    EXPECT_EQ(exited(0), ext::$("test", "a b", "=", "a b"));
+    EXPECT_EQ(exited(1), ext::$("test", "a", "=", "b"));
+}
+
+TEST(Process, Signal) {
+    const auto status = sh("kill -9 $$");
+
+    EXPECT_EQ(CLD_KILLED, status.code);
+    EXPECT_EQ(SIGKILL, status.status);
+}
+
+TEST(Process, Directory) {
+    auto options = ext::spawn_options();
+    options.directory = "/";
+
+    EXPECT_EQ(exited(0), sh("test \"$(pwd)\" = /", options));
+}
+
+TEST(Process, Environment) {
+    auto options = ext::spawn_options();
+    options.environment = ext::string_map {{"FOO", "bar baz"}, {"EMPTY", ""}};
+
+    EXPECT_EQ(
+        exited(0),
+        sh("test \"$FOO\" = 'bar baz' && test -z \"$HOME\"", options)
+    );
+}
+
+TEST(Process, FileDescriptors) {
+    char path[] = "/tmp/ext.process.XXXXXX";
+    const auto fd = mkstemp(path);
+    ASSERT_NE(-1, fd);
+    unlink(path);
+
+    auto options = ext::spawn_options();
+    options.fds = {{.child = 1, .parent = fd}};
+
+    EXPECT_EQ(exited(0), sh("echo hello", options));
+
+    char buffer[16] = {};
+    ASSERT_EQ(6, pread(fd, buffer, sizeof(buffer), 0));
+    close(fd);
+
+    EXPECT_EQ("hello\n"sv, std::string_view(buffer, 6));
+}
+
+TEST(Process, MissingProgram) {
+    EXPECT_THROW(ext::$("ext-no-such-program"), std::system_error);
+}
+
+TEST(Process, AsyncWait) {
+    auto monitor = ext::child_monitor();
+    auto statuses = std::vector<ext::exit_status>(20);
+
+    const auto wait = [&](ext::process process, std::size_t index)
+        -> ext::detached_task {
+        statuses[index] = co_await process.async_wait(monitor);
+    };
+
+    for (auto i = 0ul; i < statuses.size(); ++i) {
+        const auto script = fmt::format("sleep 0.0{}; exit {}", i % 5, i);
+        const auto args = std::array {"-c"sv, std::string_view(script)};
+
+        wait(ext::spawn("sh", args), i);
+    }
+
+    EXPECT_FALSE(monitor.empty());
+    monitor.run();
+    EXPECT_TRUE(monitor.empty());
+
+    for (auto i = 0; i < static_cast<int>(statuses.size()); ++i) {
+        EXPECT_EQ(exited(i), statuses[i]);
+    }
+}
+
+TEST(Process, AsyncWaitExited) {
+    auto monitor = ext::child_monitor();
+    auto status = std::optional<ext::exit_status>();
+
+    const auto process = ext::exec_bg("true", {});
+
+    // Give the child time to exit before waiting for it.
+    std::this_thread::sleep_for(50ms);
+
+    const auto wait = [&]() -> ext::detached_task {
+        status = co_await process.async_wait(monitor);
+    };
+
+    wait();
+
+    EXPECT_EQ(1, monitor.poll());
+    EXPECT_EQ(exited(0), status);
+}
+
+TEST(Process, CaptureLines) {
+    const auto args =
+        std::array {"-c"sv, "echo one; echo; echo three; printf four"sv};
+    auto options = ext::spawn_options();
+    options.out = ext::stdio::pipe;
+
+    auto process = ext::spawn("sh", args, options);
+
+    auto reader = ext::fd_reader(process.stdout_fd().get(), 4);
+    auto lines = reader.lines();
+    auto result = std::vector<std::string>();
+
+    while (lines) result.emplace_back(lines());
+
+    EXPECT_EQ(
+        (std::vector<std::string> {"one", "", "three", "four"}),
+        result
+    );
+    EXPECT_EQ(exited(0), process.wait());
+}
+
+TEST(Process, Input) {
+    auto options = ext::spawn_options();
+    options.in = ext::stdio::pipe;
+    options.out = ext::stdio::pipe;
+
+    auto process =
+        ext::spawn("tr", std::array {"a-z"sv, "A-Z"sv}, options);
+
+    constexpr auto text = "hello\n"sv;
+    ASSERT_EQ(
+        text.size(),
+        write(process.stdin_fd().get(), text.data(), text.size())
+    );
+    process.stdin_fd().reset();
+
+    auto reader = ext::fd_reader(process.stdout_fd().get());
+    auto output = std::string();
+
+    for (auto chunk = reader.read(); !chunk.empty(); chunk = reader.read()) {
+        output += chunk;
+    }
+
+    EXPECT_EQ("HELLO\n", output);
+    EXPECT_EQ(exited(0), process.wait());
+}
+
+TEST(Process, Null) {
+    auto options = ext::spawn_options();
+    options.in = ext::stdio::null;
+    options.out = ext::stdio::pipe;
+    options.err = ext::stdio::null;
+
+    auto process = ext::spawn(
+        "sh",
+        std::array {"-c"sv, "cat; echo error >&2"sv},
+        options
+    );
+
+    auto reader = ext::fd_reader(process.stdout_fd().get());
+
+    EXPECT_TRUE(reader.read().empty());
+    EXPECT_EQ(exited(0), process.wait());
+}
+
+TEST(Process, Splice) {
+    auto options = ext::spawn_options();
+    options.out = ext::stdio::pipe;
+
+    auto process =
+        ext::spawn("sh", std::array {"-c"sv, "echo spliced"sv}, options);
+
+    char path[] = "/tmp/ext.process.XXXXXX";
+    const auto file = ext::unique_fd(mkstemp(path));
+    ASSERT_TRUE(file);
+    unlink(path);
+
+    EXPECT_EQ(8, ext::splice_all(process.stdout_fd().get(), file.get()));
+    EXPECT_EQ(exited(0), process.wait());
+
+    char buffer[8];
+    ASSERT_EQ(8, pread(file.get(), buffer, sizeof(buffer), 0));
+    EXPECT_EQ("spliced\n"sv, std::string_view(buffer, sizeof(buffer)));
+}
+
+TEST(Process, Tee) {
+    auto source = ext::open_pipe();
+    auto copy = ext::open_pipe();
+
+    ASSERT_EQ(3, write(source.write.get(), "abc", 3));
+    EXPECT_EQ(3, ext::tee(source.read.get(), copy.write.get(), 3));
+
+    source.write.reset();
+    copy.write.reset();
+
+    auto original = ext::fd_reader(source.read.get());
+    auto duplicate = ext::fd_reader(copy.read.get());
+
+    EXPECT_EQ("abc"sv, original.read());
+    EXPECT_EQ("abc"sv, duplicate.read());
+}
+
+TEST(Process, ResourceUsage) {
+    const auto args = std::array {"-c"sv, "exec head -c 4000000 /dev/zero"sv};
+    auto options = ext::spawn_options();
+    options.out = ext::stdio::null;
+
+    auto process = ext::spawn("sh", args, options);
+
+    auto usage = ext::resource_usage();
+    EXPECT_EQ(exited(0), process.wait(usage));
+
+    EXPECT_GT(usage.max_rss, 0);
+    EXPECT_GT(usage.minor_faults, 0);
+}
+
+TEST(Process, ResourceUsageSignal) {
+    const auto args = std::array {"-c"sv, "kill -9 $$"sv};
+    auto usage = ext::resource_usage();
+
+    const auto status = ext::spawn("sh", args).wait(usage);
+
+    EXPECT_EQ(CLD_KILLED, status.code);
+    EXPECT_EQ(SIGKILL, status.status);
+}
+
+TEST(Process, AsyncWaitDestroyed) {
+    auto monitor = ext::child_monitor();
+    auto victim = std::optional<ext::jtask<>>();
+    auto resumed = false;
+
+    const auto first = ext::exec_bg("true", {});
+    const auto second = ext::exec_bg("true", {});
+
+    // Let both children exit, so that both waiters are ready at once.
+    std::this_thread::sleep_for(50ms);
+
+    const auto target = [&]() -> ext::jtask<> {
+        co_await monitor.exited(second.pid());
+        resumed = true;
+    };
+
+    const auto killer = [&]() -> ext::jtask<> {
+        co_await monitor.exited(first.pid());
+        victim.reset();
+    };
+
+    auto task = killer();
+    victim.emplace(target());
+    monitor.run();
+
+    EXPECT_TRUE(task.is_ready());
+    EXPECT_FALSE(resumed);
+
+    first.wait();
+    second.wait();
+}
+
+TEST(Process, AsyncWaitSharedLoop) {
+    auto loop = ext::event_loop();
+    auto monitor = ext::child_monitor(loop);
+    auto order = std::string();
+
+    const auto wait = [&]() -> ext::detached_task {
+        co_await ext::spawn("sh", std::array {"-c"sv, "sleep 0.05"sv})
+            .async_wait(monitor);
+        order.push_back('p');
+    };
+
+    const auto sleep = [&]() -> ext::detached_task {
+        co_await loop.sleep_for(1ms);
+        order.push_back('t');
+    };
+
+    wait();
+    sleep();
+    loop.run();
+
+    EXPECT_TRUE(monitor.empty());
+    EXPECT_EQ("tp", order);
+}
+
+TEST(Process, WaitInterrupted) {
+    // A handler installed without SA_RESTART makes the wait fail with
+    // EINTR when the signal arrives.
+    struct sigaction action = {};
+    struct sigaction previous = {};
+    action.sa_handler = [](int) {};
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGALRM, &action, &previous);
+
+    auto timer = itimerval();
+    timer.it_value.tv_usec = 10'000;
+
+    const auto args = std::array {"-c"sv, "sleep 0.1; exit 3"sv};
+
+    setitimer(ITIMER_REAL, &timer, nullptr);
+    EXPECT_EQ(exited(3), ext::spawn("sh", args).wait());
+
+    setitimer(ITIMER_REAL, &timer, nullptr);
+    auto usage = ext::resource_usage();
+    EXPECT_EQ(exited(3), ext::spawn("sh", args).wait(usage));
+
+    sigaction(SIGALRM, &previous, nullptr);
+}
+
+TEST(Process, AsyncWaitResourceUsage) {
+    auto monitor = ext::child_monitor();
+    auto status = ext::exit_status();
+    auto usage = ext::resource_usage();
+
+    const auto wait = [&](ext::process process) -> ext::detached_task {
+        status = co_await process.async_wait(monitor, usage);
+    };
+
+    wait(ext::spawn("true", {}));
+    monitor.run();
+
+    EXPECT_EQ(exited(0), status);
+    EXPECT_GT(usage.max_rss, 0);
+}
+
+TEST(ResourceUsage, Add) {
+    using namespace std::chrono_literals;
+
+    auto total = ext::resource_usage {
+        .user_time = 1s,
+        .system_time = 2ms,
+        .max_rss = 100,
+        .minor_faults = 1,
+        .major_faults = 2,
+        .voluntary_switches = 3,
+        .involuntary_switches = 4
+    };
+
+    total += {
+        .user_time = 1s,
+        .system_time = 1ms,
+        .max_rss = 50,
+        .minor_faults = 1,
+        .major_faults = 1,
+        .voluntary_switches = 1,
+        .involuntary_switches = 1
+    };
+
+    EXPECT_EQ(
+        (ext::resource_usage {
+            .user_time = 2s,
+            .system_time = 3ms,
+            .max_rss = 100,
+            .minor_faults = 2,
+            .major_faults = 3,
+            .voluntary_switches = 4,
+            .involuntary_switches = 5
+        }),
+        total
+    );
+}
+
+TEST(Process, WaitErrorCode) {
+    const auto process = ext::spawn("true", {});
+    auto ec = std::error_code();
+
+    EXPECT_EQ(exited(0), process.wait(ec));
+    EXPECT_FALSE(ec);
+
+    // The process has already been reaped.
+    process.wait(ec);
+    EXPECT_EQ(std::errc::no_child_process, ec);
+    EXPECT_THROW(process.wait(), std::system_error);
+}
+
+TEST(Process, ExecErrorCode) {
+    auto ec = std::error_code();
+
+    ext::exec("ext-process-test-missing", {}, ec);
+    EXPECT_EQ(std::errc::no_such_file_or_directory, ec);
+}
+
+TEST(Process, CloseFds) {
+    const auto fd = open("/dev/null", O_RDONLY);
+    const auto cloexec = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    ASSERT_NE(-1, fd);
+    ASSERT_NE(-1, cloexec);
+
+    const auto is_open = [](int fd) {
+        return fmt::format("test -e /proc/$$/fd/{}", fd);
+    };
+
+    EXPECT_EQ(exited(0), sh(is_open(fd)));
+    EXPECT_EQ(exited(1), sh(is_open(cloexec)));
+
+    auto closing = ext::spawn_options();
+    closing.close_fds = true;
+    EXPECT_EQ(exited(1), sh(is_open(fd), closing));
+
+    closing.keep_fds = {fd};
+    EXPECT_EQ(exited(0), sh(is_open(fd), closing));
+
+    auto keep = ext::spawn_options();
+    keep.keep_fds = {cloexec};
+    EXPECT_EQ(exited(0), sh(is_open(cloexec), keep));
+
+    auto mapped = ext::spawn_options();
+    mapped.fds = {{.child = 9, .parent = fd}};
+    mapped.close_fds = true;
+
+    EXPECT_EQ(exited(0), sh(is_open(9), mapped));
+    EXPECT_EQ(exited(1), sh(is_open(fd), mapped));
+
+    close(fd);
+    close(cloexec);
+}
+
+TEST(Process, InheritedEnvironment) {
+    setenv("EXT_PROCESS_TEST", "value", 1);
+
+    auto environment = ext::environment();
+    EXPECT_EQ("value", environment.at("EXT_PROCESS_TEST"));
+
+    environment["EXT_PROCESS_TEST"] = "changed";
+
+    auto options = ext::spawn_options();
+    options.environment = std::move(environment);
+
+    EXPECT_EQ(exited(0), sh("test \"$EXT_PROCESS_TEST\" = changed", options));
+    EXPECT_STREQ("value", getenv("EXT_PROCESS_TEST"));
+
+    unsetenv("EXT_PROCESS_TEST");
+}
@@ -0,0 +1,288 @@
+#include <ext/detail/record_reader.hpp>
+
+#include <bit>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+    /**
+     * Returns a pointer to the first delimiter or line feed in the range, or
+     * 'end' if there is none.
+     */
+    auto find_field_end(const char* it, const char* end, char delimiter)
+        -> const char* {
+#ifdef __SSE2__
+        const auto delimiters = _mm_set1_epi8(delimiter);
+        const auto newlines = _mm_set1_epi8('\n');
+
+        while (end - it >= 16) {
+            const auto bytes =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+            const auto matches = _mm_or_si128(
+                _mm_cmpeq_epi8(bytes, delimiters),
+                _mm_cmpeq_epi8(bytes, newlines)
+            );
+
+            if (const auto mask = _mm_movemask_epi8(matches)) {
+                return it + std::countr_zero(static_cast<unsigned int>(mask));
+            }
+
+            it += 16;
+        }
+#endif
+
+        while (it != end && *it != delimiter && *it != '\n') ++it;
+        return it;
+    }
+
+    auto strip_cr(std::string_view field) -> std::string_view {
+        if (!field.empty() && field.back() == '\r') field.remove_suffix(1);
+        return field;
+    }
+}
+
+namespace ext {
+    record_reader::record_reader(record_options options) : options(options) {}
+
+    record_reader::record_reader(
+        std::string_view buffer,
+        record_options options
+    ) :
+        options(options),
+        input(buffer),
+        last(true) {}
+
+    auto record_reader::parse(const char* begin, const char* end, bool final)
+        -> const char* {
+        fields.clear();
+        unescaped.clear();
+        scratch.clear();
+
+        const auto delimiter = options.delimiter;
+        const auto quote = options.quote;
+
+        auto* p = begin;
+
+        while (true) {
+            if (quote != '\0' && p != end && *p == quote) {
+                const auto* const start = p + 1;
+                const auto* closing = start;
+                auto escaped = false;
+
+                while (true) {
+                    closing = static_cast<const char*>(
+                        std::memchr(closing, quote, end - closing)
+                    );
+
+                    // An unterminated quoted field extends to the end of
+                    // the input.
+                    if (!closing) {
+                        if (!final) return nullptr;
+                        closing = end;
+                        break;
+                    }
+
+                    // Whether a quote at the very end of the chunk is
+                    // escaped depends on the next chunk.
+                    if (closing + 1 == end && !final) return nullptr;
+
+                    if (closing + 1 != end && closing[1] == quote) {
+                        escaped = true;
+                        closing += 2;
+                        continue;
+                    }
+
+                    break;
+                }
+
+                p = closing == end ? end : closing + 1;
+
+                // Text between the closing quote and the next delimiter is
+                // kept as is.
+                const auto* const field_end =
+                    find_field_end(p, end, delimiter);
+                if (field_end == end && !final) return nullptr;
+
+                const auto trailing =
+                    strip_cr(std::string_view(p, field_end - p));
+                const auto content = std::string_view(start, closing - start);
+
+                if (escaped || !trailing.empty()) {
+                    const auto offset = scratch.size();
+
+                    for (auto i = 0ul; i < content.size(); ++i) {
+                        scratch.push_back(content[i]);
+                        if (content[i] == quote) ++i;
+                    }
+
+                    scratch.append(trailing);
+
+                    unescaped.push_back(
+                        {fields.size(), offset, scratch.size() - offset}
+                    );
+                    fields.emplace_back();
+                }
+                else fields.push_back(content);
+
+                p = field_end;
+            }
+            else {
+                const auto* const field_end =
+                    find_field_end(p, end, delimiter);
+                if (field_end == end && !final) return nullptr;
+
+                fields.push_back(strip_cr({p, field_end}));
+                p = field_end;
+            }
+
+            if (p == end) break;
+
+            if (*p == '\n') {
+                ++p;
+                break;
+            }
+
+            // Skip the delimiter. If it is the last byte of the chunk, the
+            // following field is unknown until more input arrives.
+            if (++p == end && !final) return nullptr;
+        }
+
+        for (const auto& field : unescaped) {
+            fields[field.index] =
+                std::string_view(scratch.data() + field.offset, field.length);
+        }
+
+        return p;
+    }
+
+    auto record_reader::feed(std::string_view chunk) -> void {
+        // Drop the records already returned from the carried over input.
+        partial.erase(0, partial_position);
+        scanned -= partial_position;
+        partial_position = 0;
+
+        // Any unread input belongs to records that continue in the new
+        // chunk.
+        if (position < input.size()) partial.append(input.substr(position));
+
+        input = chunk;
+        position = 0;
+    }
+
+    auto record_reader::finish() -> void { last = true; }
+
+    auto record_reader::next()
+        -> std::optional<std::span<const std::string_view>> {
+        if (partial_position == partial.size()) {
+            partial.clear();
+            partial_position = 0;
+            scanned = 0;
+        }
+
+        // Complete a record that began in an earlier chunk by copying the
+        // current chunk up to the end of the record.
+        while (partial_position < partial.size()) {
+            if (const auto* const stop = scan(
+                    partial.data() + scanned,
+                    partial.data() + partial.size()
+                )) {
+                scanned = stop - partial.data();
+                return take_partial(scanned, false);
+            }
+
+            scanned = partial.size();
+
+            if (position == input.size()) {
+                if (last) return take_partial(partial.size(), true);
+                return std::nullopt;
+            }
+
+            const auto* const begin = input.data() + position;
+            const auto* const end = input.data() + input.size();
+            const auto* const stop = scan(begin, end);
+            const auto* const copied = stop ? stop : end;
+
+            partial.append(begin, copied);
+            position = copied - input.data();
+            scanned = partial.size();
+
+            if (stop) return take_partial(scanned, false);
+        }
+
+        if (position == input.size()) return std::nullopt;
+
+        const auto* const begin = input.data() + position;
+        const auto* const end = input.data() + input.size();
+
+        if (const auto* const stop = parse(begin, end, last)) {
+            position = stop - input.data();
+            return fields;
+        }
+
+        // The record is incomplete: carry it over, remembering how far it
+        // has been scanned.
+        partial.assign(begin, end);
+        position = input.size();
+        scan(partial.data(), partial.data() + partial.size());
+        scanned = partial.size();
+
+        return std::nullopt;
+    }
+
+    auto record_reader::scan(const char* it, const char* end)
+        -> const char* {
+        const auto delimiter = options.delimiter;
+        const auto quote = options.quote;
+
+        for (; it != end; ++it) {
+            const auto c = *it;
+
+            switch (state) {
+                case scan_state::field_start:
+                    if (quote != '\0' && c == quote) {
+                        state = scan_state::quoted;
+                        continue;
+                    }
+                    break;
+                case scan_state::quoted:
+                    if (c == quote) state = scan_state::quote;
+                    continue;
+                case scan_state::quote:
+                    // A doubled quote character is escaped; anything else
+                    // follows the closing quote.
+                    if (c == quote) {
+                        state = scan_state::quoted;
+                        continue;
+                    }
+                    break;
+                case scan_state::unquoted:
+                    break;
+            }
+
+            if (c == '\n') {
+                state = scan_state::field_start;
+                return it + 1;
+            }
+
+            state = c == delimiter ? scan_state::field_start
+                                   : scan_state::unquoted;
+        }
+
+        return nullptr;
+    }
+
+    auto record_reader::take_partial(std::size_t end, bool final)
+        -> std::span<const std::string_view> {
+        const auto* const data = partial.data();
+        const auto* const stop =
+            parse(data + partial_position, data + end, final);
+
+        partial_position = stop - data;
+        state = scan_state::field_start;
+
+        return fields;
+    }
+}
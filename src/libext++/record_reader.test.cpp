@@ -0,0 +1,173 @@
+#include <ext/record_reader>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+namespace {
+    using record = std::vector<std::string>;
+
+    auto read_all(ext::record_reader& reader) -> std::vector<record> {
+        auto result = std::vector<record>();
+
+        while (const auto fields = reader.next()) {
+            result.emplace_back(fields->begin(), fields->end());
+        }
+
+        return result;
+    }
+
+    auto read_chunks(std::string_view input, std::size_t chunk_size)
+        -> std::vector<record> {
+        auto reader = ext::record_reader();
+        auto result = std::vector<record>();
+
+        for (auto i = 0ul; i < input.size(); i += chunk_size) {
+            reader.feed(input.substr(i, chunk_size));
+
+            for (auto&& record : read_all(reader)) {
+                result.push_back(std::move(record));
+            }
+        }
+
+        reader.finish();
+        for (auto&& record : read_all(reader)) {
+            result.push_back(std::move(record));
+        }
+
+        return result;
+    }
+}
+
+TEST(RecordReader, Plain) {
+    auto reader = ext::record_reader("a,b,c\n1,2,3\n");
+
+    const auto records = read_all(reader);
+
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ((record {"a", "b", "c"}), records[0]);
+    EXPECT_EQ((record {"1", "2", "3"}), records[1]);
+}
+
+TEST(RecordReader, NoTrailingNewline) {
+    auto reader = ext::record_reader("a,b\r\nc,");
+
+    const auto records = read_all(reader);
+
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ((record {"a", "b"}), records[0]);
+    EXPECT_EQ((record {"c", ""}), records[1]);
+}
+
+TEST(RecordReader, Quoted) {
+    auto reader =
+        ext::record_reader("\"a,b\",\"line\nbreak\",\"say \"\"hi\"\"\"\n");
+
+    const auto records = read_all(reader);
+
+    ASSERT_EQ(1, records.size());
+    EXPECT_EQ((record {"a,b", "line\nbreak", "say \"hi\""}), records[0]);
+}
+
+TEST(RecordReader, ZeroCopy) {
+    constexpr auto input = "foo,\"bar\",\"b\"\"az\"\n"sv;
+    auto reader = ext::record_reader(input);
+
+    const auto fields = *reader.next();
+    const auto contains = [&](std::string_view field) {
+        return field.data() >= input.data() &&
+               field.data() + field.size() <= input.data() + input.size();
+    };
+
+    ASSERT_EQ(3, fields.size());
+    EXPECT_TRUE(contains(fields[0]));
+    EXPECT_TRUE(contains(fields[1]));
+    EXPECT_FALSE(contains(fields[2]));
+    EXPECT_EQ("b\"az"sv, fields[2]);
+}
+
+TEST(RecordReader, Tsv) {
+    auto reader = ext::record_reader(
+        "a\tb,c\t'd\te'\n",
+        {.delimiter = '\t', .quote = '\''}
+    );
+
+    const auto records = read_all(reader);
+
+    ASSERT_EQ(1, records.size());
+    EXPECT_EQ((record {"a", "b,c", "d\te"}), records[0]);
+}
+
+TEST(RecordReader, Chunks) {
+    constexpr auto input = "id,name,note\r\n"
+                           "1,\"Smith, J\",\"said \"\"ok\"\"\"\n"
+                           "2,,\"multi\nline\"\n"
+                           "3,x,\"\"\n"
+                           "4,\"\",last"sv;
+
+    auto whole = ext::record_reader(input);
+    const auto expected = read_all(whole);
+
+    ASSERT_EQ(5, expected.size());
+    EXPECT_EQ((record {"1", "Smith, J", "said \"ok\""}), expected[1]);
+    EXPECT_EQ((record {"2", "", "multi\nline"}), expected[2]);
+    EXPECT_EQ((record {"4", "", "last"}), expected[4]);
+
+    for (auto size = 1ul; size <= input.size(); ++size) {
+        EXPECT_EQ(expected, read_chunks(input, size)) << "chunk size " << size;
+    }
+}
+
+TEST(RecordReader, FeedBeforeDrain) {
+    auto reader = ext::record_reader();
+
+    reader.feed("a,b\nc,d\ne,");
+    const auto first = reader.next();
+    ASSERT_TRUE(first);
+    EXPECT_EQ((record {"a", "b"}), record(first->begin(), first->end()));
+
+    reader.feed("f\ng,h\n");
+    reader.finish();
+
+    const auto records = read_all(reader);
+
+    ASSERT_EQ(3, records.size());
+    EXPECT_EQ((record {"c", "d"}), records[0]);
+    EXPECT_EQ((record {"e", "f"}), records[1]);
+    EXPECT_EQ((record {"g", "h"}), records[2]);
+}
+
+TEST(RecordReader, FeedBeforeDrainChunks) {
+    constexpr auto input = "a,\"b\nc\"\n"
+                           "d,\"\"\"e\"\"\"\n"
+                           "f,g\n"
+                           "h,\"i,j\"\n"
+                           "k,l"sv;
+
+    auto whole = ext::record_reader(input);
+    const auto expected = read_all(whole);
+
+    ASSERT_EQ(5, expected.size());
+
+    for (auto size = 1ul; size <= input.size(); ++size) {
+        auto reader = ext::record_reader();
+        auto result = std::vector<record>();
+
+        // Read at most one record per chunk, so that records pile up
+        // behind those still being read.
+        for (auto i = 0ul; i < input.size(); i += size) {
+            reader.feed(input.substr(i, size));
+
+            if (const auto fields = reader.next()) {
+                result.emplace_back(fields->begin(), fields->end());
+            }
+        }
+
+        reader.finish();
+        for (auto&& record : read_all(reader)) {
+            result.push_back(std::move(record));
+        }
+
+        EXPECT_EQ(expected, result) << "chunk size " << size;
+    }
+}
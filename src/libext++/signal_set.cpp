@@ -0,0 +1,108 @@
+#include <ext/signal_set>
+#include <ext/except.h>
+
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace ext {
+    signal_set::awaiter::awaiter(signal_set& signals) noexcept :
+        signals(signals) {}
+
+    auto signal_set::awaiter::await_ready() -> bool {
+        // Coroutines that are already waiting are served first.
+        if (!signals.waiting.empty()) return false;
+        return signals.first != signals.last || signals.fill();
+    }
+
+    auto signal_set::awaiter::await_suspend(
+        std::coroutine_handle<> coroutine
+    ) noexcept -> void {
+        node.coroutine = coroutine;
+        signals.waiting.enqueue(node);
+    }
+
+    auto signal_set::awaiter::await_resume() noexcept -> signalfd_siginfo {
+        return signals.take();
+    }
+
+    signal_set::signal_set(std::initializer_list<int> signals) {
+        auto mask = sigset_t();
+        sigemptyset(&mask);
+
+        for (const auto signal : signals) sigaddset(&mask, signal);
+
+        const auto ret = pthread_sigmask(SIG_BLOCK, &mask, &previous);
+        if (ret != 0) {
+            throw std::system_error(
+                ret,
+                std::generic_category(),
+                "failed to block signals"
+            );
+        }
+
+        fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (fd == -1) {
+            const auto error = errno;
+            pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+
+            errno = error;
+            throw ext::system_error("failed to create signalfd");
+        }
+    }
+
+    signal_set::~signal_set() {
+        close(fd);
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+    }
+
+    auto signal_set::empty() const noexcept -> bool { return waiting.empty(); }
+
+    auto signal_set::fill() -> bool {
+        const auto bytes = read(fd, buffer.data(), sizeof(buffer));
+
+        if (bytes == -1) {
+            if (errno == EAGAIN || errno == EINTR) return false;
+            throw ext::system_error("failed to read signals");
+        }
+
+        first = 0;
+        last = bytes / sizeof(signalfd_siginfo);
+
+        return last > 0;
+    }
+
+    auto signal_set::native_handle() const noexcept -> int { return fd; }
+
+    auto signal_set::next() noexcept -> awaiter { return awaiter(*this); }
+
+    auto signal_set::poll(std::chrono::milliseconds timeout) -> std::size_t {
+        if (first == last) {
+            auto pfd = pollfd {.fd = fd, .events = POLLIN, .revents = 0};
+            const auto count =
+                ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+
+            if (count == -1) {
+                if (errno == EINTR) return 0;
+                throw ext::system_error("failed to wait for signals");
+            }
+
+            if (count == 0 || !fill()) return 0;
+        }
+
+        auto resumed = std::size_t();
+
+        // A resumed coroutine may take more buffered signals before it
+        // suspends again, so check the buffer after each one.
+        while (first != last && !waiting.empty()) {
+            waiting.pop();
+            ++resumed;
+        }
+
+        return resumed;
+    }
+
+    auto signal_set::take() noexcept -> signalfd_siginfo {
+        return buffer[first++];
+    }
+}
@@ -0,0 +1,109 @@
+#include <ext/coroutine>
+#include <ext/signal_set>
+#include <ext/unix.h>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+TEST(SignalSet, Next) {
+    auto signals = ext::signal_set({SIGUSR1, SIGUSR2});
+    auto received = std::vector<int>();
+
+    const auto listen = [&]() -> ext::detached_task {
+        for (auto i = 0; i < 2; ++i) {
+            const auto info = co_await signals.next();
+            received.push_back(info.ssi_signo);
+        }
+    };
+
+    listen();
+    EXPECT_FALSE(signals.empty());
+    EXPECT_TRUE(received.empty());
+
+    raise(SIGUSR1);
+    EXPECT_EQ(1, signals.poll());
+    EXPECT_EQ(std::vector {SIGUSR1}, received);
+
+    raise(SIGUSR2);
+    EXPECT_EQ(1, signals.poll());
+    EXPECT_EQ((std::vector {SIGUSR1, SIGUSR2}), received);
+    EXPECT_TRUE(signals.empty());
+}
+
+TEST(SignalSet, Pending) {
+    auto signals = ext::signal_set({SIGUSR1, SIGUSR2});
+    auto received = std::vector<int>();
+
+    raise(SIGUSR2);
+    raise(SIGUSR1);
+
+    const auto listen = [&]() -> ext::detached_task {
+        for (auto i = 0; i < 2; ++i) {
+            const auto info = co_await signals.next();
+            received.push_back(info.ssi_signo);
+        }
+    };
+
+    // Both signals were already pending and are read together, so the
+    // coroutine receives them without suspending.
+    listen();
+
+    EXPECT_EQ(2, received.size());
+    EXPECT_TRUE(signals.empty());
+}
+
+TEST(SignalSet, Timeout) {
+    auto signals = ext::signal_set({SIGUSR1});
+    EXPECT_EQ(0, signals.poll(0ms));
+}
+
+TEST(SignalSet, Fairness) {
+    auto signals = ext::signal_set({SIGUSR1, SIGUSR2});
+    auto received = std::array<int, 2>();
+
+    const auto listen = [&](std::size_t index) -> ext::detached_task {
+        received[index] = (co_await signals.next()).ssi_signo;
+    };
+
+    listen(0);
+    listen(1);
+
+    raise(SIGUSR1);
+    raise(SIGUSR2);
+
+    EXPECT_EQ(2, signals.poll());
+    EXPECT_TRUE(signals.empty());
+    EXPECT_EQ(SIGUSR1, received[0]);
+    EXPECT_EQ(SIGUSR2, received[1]);
+}
+
+TEST(SignalSet, ChildExited) {
+    auto signals = ext::signal_set({SIGCHLD});
+    auto pid = pid_t();
+
+    const auto listen = [&]() -> ext::detached_task {
+        const auto info = co_await signals.next();
+        pid = info.ssi_pid;
+    };
+
+    listen();
+
+    const auto process = ext::spawn("true", {});
+
+    while (!signals.empty()) signals.poll();
+
+    EXPECT_EQ(process.pid(), pid);
+    EXPECT_EQ(CLD_EXITED, process.wait().code);
+}
+
+TEST(SignalSet, RestoresMask) {
+    {
+        auto signals = ext::signal_set({SIGUSR1});
+    }
+
+    auto mask = sigset_t();
+    pthread_sigmask(SIG_SETMASK, nullptr, &mask);
+
+    EXPECT_FALSE(sigismember(&mask, SIGUSR1));
+}
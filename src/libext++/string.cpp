@@ -1,8 +1,116 @@
 #include <ext/string.h>
 
+#include <bit>
+#include <cstring>
 #include <stdexcept>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+#ifdef __SSE2__
+    constexpr auto simd_width = std::ptrdiff_t(16);
+    constexpr auto full_mask = 0xffffu;
+
+    /**
+     * Returns a 16-bit mask with a bit set for every ASCII whitespace
+     * character in the 16 bytes starting at 'data'.
+     */
+    auto whitespace_mask(const char* data) -> unsigned int {
+        const auto bytes =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+
+        // '\t', '\n', '\v', '\f' and '\r' are the contiguous range 9-13:
+        // after subtracting 9, they are exactly the bytes at most 4.
+        const auto offset = _mm_sub_epi8(bytes, _mm_set1_epi8(9));
+        const auto control = _mm_cmpeq_epi8(
+            _mm_subs_epu8(offset, _mm_set1_epi8(4)),
+            _mm_setzero_si128()
+        );
+        const auto space = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+
+        return _mm_movemask_epi8(_mm_or_si128(control, space));
+    }
+#endif
+}
+
 namespace ext {
+    auto find(
+        std::string_view haystack,
+        std::string_view needle,
+        std::size_t pos
+    ) noexcept -> std::size_t {
+        if (pos > haystack.size()) return std::string_view::npos;
+        if (needle.empty()) return pos;
+        if (needle.size() > haystack.size() - pos) {
+            return std::string_view::npos;
+        }
+
+        const auto* const begin = haystack.data();
+        const auto* const end = begin + haystack.size();
+        const auto* it = begin + pos;
+
+        if (needle.size() == 1) {
+            const auto* const match =
+                std::memchr(it, needle.front(), end - it);
+            if (!match) return std::string_view::npos;
+            return static_cast<const char*>(match) - begin;
+        }
+
+        // The last position at which the needle can start.
+        const auto* const last = end - needle.size();
+
+#ifdef __SSE2__
+        const auto first_byte = _mm_set1_epi8(needle.front());
+        const auto last_byte = _mm_set1_epi8(needle.back());
+        const auto* const rest = needle.data() + 1;
+        const auto rest_size = needle.size() - 2;
+
+        // Compare 16 candidate positions at once, checking the first and
+        // last bytes of the needle; only the candidates where both match
+        // are compared in full.
+        while (last - it >= simd_width - 1) {
+            const auto firsts = _mm_cmpeq_epi8(
+                first_byte,
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(it))
+            );
+            const auto lasts = _mm_cmpeq_epi8(
+                last_byte,
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                    it + needle.size() - 1
+                ))
+            );
+
+            auto mask = static_cast<unsigned int>(
+                _mm_movemask_epi8(_mm_and_si128(firsts, lasts))
+            );
+
+            while (mask != 0) {
+                const auto* const candidate = it + std::countr_zero(mask);
+                if (std::memcmp(candidate + 1, rest, rest_size) == 0) {
+                    return candidate - begin;
+                }
+
+                mask &= mask - 1;
+            }
+
+            it += simd_width;
+        }
+#endif
+
+        for (; it <= last; ++it) {
+            if (*it != needle.front()) continue;
+
+            if (std::memcmp(it + 1, needle.data() + 1, needle.size() - 1) ==
+                0) {
+                return it - begin;
+            }
+        }
+
+        return std::string_view::npos;
+    }
+
     constexpr auto environment_variable_regex = "\\$([a-zA-Z_]+[a-zA-Z0-9_]*)";
 
     auto expand_env(std::string_view string) -> std::string {
@@ -23,9 +131,29 @@ namespace ext {
         );
     }
 
-    auto split(std::string_view sequence, std::string_view delimiter)
-        -> std::vector<std::string_view> {
-        auto range = ext::string_range(sequence, delimiter);
+    auto split(
+        std::string_view sequence,
+        std::string_view delimiter,
+        split_options options
+    ) -> std::vector<std::string_view> {
+        auto range = ext::string_range(sequence, delimiter, options);
+        return std::vector<std::string_view>(range.begin(), range.end());
+    }
+
+    auto split(
+        std::string_view sequence,
+        const char* delimiter,
+        split_options options
+    ) -> std::vector<std::string_view> {
+        return split(sequence, std::string_view(delimiter), options);
+    }
+
+    auto split(
+        std::string_view sequence,
+        const charset& delimiters,
+        split_options options
+    ) -> std::vector<std::string_view> {
+        auto range = ext::string_range(sequence, delimiters, options);
         return std::vector<std::string_view>(range.begin(), range.end());
     }
 
@@ -33,33 +161,84 @@ namespace ext {
         return trim_end(trim_start(string));
     }
 
+    auto trim(std::string_view string, const charset& chars)
+        -> std::string_view {
+        return trim_end(trim_start(string, chars), chars);
+    }
+
     auto trim_start(std::string_view string) -> std::string_view {
-        const auto* begin = string.begin();
+        const auto* const begin = string.data();
+        const auto* const end = begin + string.size();
+        const auto* it = begin;
+
+#ifdef __SSE2__
+        while (end - it >= simd_width) {
+            const auto mask = whitespace_mask(it);
+            if (mask != full_mask) {
+                it += std::countr_one(mask);
+                string.remove_prefix(it - begin);
+                return string;
+            }
 
-        const auto* result =
-            std::find_if(begin, string.end(), [](unsigned char c) -> bool {
-                return !std::isspace(c);
-            });
+            it += simd_width;
+        }
+#endif
 
-        string.remove_prefix(std::distance(begin, result));
+        while (it != end && whitespace.contains(*it)) ++it;
+
+        string.remove_prefix(it - begin);
+        return string;
+    }
+
+    auto trim_start(std::string_view string, const charset& chars)
+        -> std::string_view {
+        const auto* const begin = string.data();
+        const auto* const end = begin + string.size();
+        const auto* it = begin;
+
+        while (it != end && chars.contains(*it)) ++it;
+
+        string.remove_prefix(it - begin);
         return string;
     }
 
     auto trim_end(std::string_view string) -> std::string_view {
-        const auto begin = string.rbegin();
+        const auto* const begin = string.data();
+        const auto* const end = begin + string.size();
+        const auto* it = end;
+
+#ifdef __SSE2__
+        while (it - begin >= simd_width) {
+            const auto mask = whitespace_mask(it - simd_width);
+            if (mask != full_mask) {
+                it -= std::countl_one(static_cast<std::uint16_t>(mask));
+                string.remove_suffix(end - it);
+                return string;
+            }
+
+            it -= simd_width;
+        }
+#endif
+
+        while (it != begin && whitespace.contains(*(it - 1))) --it;
+
+        string.remove_suffix(end - it);
+        return string;
+    }
+
+    auto trim_end(std::string_view string, const charset& chars)
+        -> std::string_view {
+        const auto* const begin = string.data();
+        const auto* const end = begin + string.size();
+        const auto* it = end;
 
-        const auto result =
-            std::find_if(begin, string.rend(), [](unsigned char c) -> bool {
-                return !std::isspace(c);
-            });
+        while (it != begin && chars.contains(*(it - 1))) --it;
 
-        string.remove_suffix(std::distance(begin, result));
+        string.remove_suffix(end - it);
         return string;
     }
 
     auto quote(std::string_view text) -> std::string {
-        auto os = std::stringstream();
-        os << "‘" << text << "‘";
-        return os.str();
+        return fmt::format("{}", quoted(text));
     }
 }
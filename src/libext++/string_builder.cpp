@@ -0,0 +1,132 @@
+#include <ext/except.h>
+#include <ext/string_builder>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+namespace ext {
+    string_builder::string_builder(std::size_t chunk_size) noexcept :
+        chunk_size(std::max(chunk_size, std::size_t(1))) {}
+
+    auto string_builder::add_chunk(std::size_t min_capacity) -> chunk& {
+        auto capacity = chunk_size;
+
+        if (!chunks.empty()) {
+            capacity = std::max(
+                capacity,
+                std::min(chunks.back().capacity * 2, max_chunk_size)
+            );
+        }
+
+        capacity = std::max(capacity, min_capacity);
+
+        return chunks.emplace_back(
+            std::unique_ptr<char[]>(new char[capacity]),
+            0,
+            capacity
+        );
+    }
+
+    auto string_builder::operator+=(std::string_view string)
+        -> string_builder& {
+        return append(string);
+    }
+
+    auto string_builder::append(std::string_view string) -> string_builder& {
+        if (string.empty()) return *this;
+
+        length += string.size();
+
+        if (!chunks.empty()) {
+            auto& last = chunks.back();
+            const auto count =
+                std::min(string.size(), last.capacity - last.size);
+
+            std::memcpy(last.data.get() + last.size, string.data(), count);
+            last.size += count;
+            string.remove_prefix(count);
+
+            if (string.empty()) return *this;
+        }
+
+        // The rest goes into a single new chunk, large enough to hold it.
+        auto& next = add_chunk(string.size());
+
+        std::memcpy(next.data.get(), string.data(), string.size());
+        next.size = string.size();
+
+        return *this;
+    }
+
+    auto string_builder::clear() noexcept -> void {
+        chunks.clear();
+        length = 0;
+    }
+
+    auto string_builder::empty() const noexcept -> bool { return length == 0; }
+
+    auto string_builder::flatten() const -> std::string {
+        auto result = std::string();
+        result.reserve(length);
+
+        for (const auto& chunk : chunks) {
+            result.append(chunk.data.get(), chunk.size);
+        }
+
+        return result;
+    }
+
+    auto string_builder::iovecs() const -> std::vector<iovec> {
+        auto result = std::vector<iovec>();
+        result.reserve(chunks.size());
+
+        for (const auto& chunk : chunks) {
+            if (chunk.size == 0) continue;
+            result.push_back({chunk.data.get(), chunk.size});
+        }
+
+        return result;
+    }
+
+    auto string_builder::push_back(char c) -> void {
+        if (chunks.empty() || chunks.back().size == chunks.back().capacity) {
+            add_chunk(1);
+        }
+
+        auto& last = chunks.back();
+        last.data[last.size++] = c;
+        ++length;
+    }
+
+    auto string_builder::size() const noexcept -> std::size_t { return length; }
+
+    auto string_builder::write(int fd) const -> void {
+        auto buffers = iovecs();
+        auto* it = buffers.data();
+        auto* const end = it + buffers.size();
+
+        while (it != end) {
+            const auto count = std::min<std::ptrdiff_t>(end - it, IOV_MAX);
+            auto written = ::writev(fd, it, static_cast<int>(count));
+
+            if (written == -1) {
+                if (errno == EINTR) continue;
+                throw ext::system_error("failed to write buffers");
+            }
+
+            // Skip the buffers that were written completely, and adjust the
+            // first one that was not.
+            while (it != end && std::size_t(written) >= it->iov_len) {
+                written -= it->iov_len;
+                ++it;
+            }
+
+            if (it != end) {
+                it->iov_base = static_cast<char*>(it->iov_base) + written;
+                it->iov_len -= written;
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include <ext/string.h>
+#include <ext/string_builder>
+
+#include <array>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+using namespace std::literals;
+
+TEST(StringBuilder, Empty) {
+    const auto builder = ext::string_builder();
+
+    EXPECT_TRUE(builder.empty());
+    EXPECT_EQ(0, builder.size());
+    EXPECT_EQ("", builder.flatten());
+    EXPECT_TRUE(builder.iovecs().empty());
+}
+
+TEST(StringBuilder, Append) {
+    auto builder = ext::string_builder(8);
+    auto expected = std::string();
+
+    for (auto i = 0; i < 100; ++i) {
+        const auto piece = fmt::format("item {};", i);
+
+        builder += piece;
+        expected += piece;
+    }
+
+    builder.push_back('!');
+    expected.push_back('!');
+
+    EXPECT_EQ(expected.size(), builder.size());
+    EXPECT_EQ(expected, builder.flatten());
+    EXPECT_GT(builder.iovecs().size(), 1);
+}
+
+TEST(StringBuilder, LargeAppend) {
+    auto builder = ext::string_builder(16);
+    const auto large = std::string(100'000, 'x');
+
+    builder.append("head").append(large).append("tail");
+
+    EXPECT_EQ("head" + large + "tail", builder.flatten());
+}
+
+TEST(StringBuilder, BackInserter) {
+    auto builder = ext::string_builder();
+    const auto items = std::array {1, 2, 3};
+
+    fmt::format_to(std::back_inserter(builder), "{}: ", "items");
+    ext::join_to(std::back_inserter(builder), items, ", ");
+
+    EXPECT_EQ("items: 1, 2, 3", builder.flatten());
+}
+
+TEST(StringBuilder, Write) {
+    auto builder = ext::string_builder(1);
+    auto expected = std::string();
+
+    for (auto i = 0; i < 100'000; ++i) {
+        builder.push_back('a' + i % 26);
+        builder += "|";
+        expected.push_back('a' + i % 26);
+        expected += "|";
+    }
+
+    char path[] = "/tmp/ext.string_builder.XXXXXX";
+    const auto fd = mkstemp(path);
+    ASSERT_NE(-1, fd);
+    unlink(path);
+
+    builder.write(fd);
+
+    auto actual = std::string(expected.size(), '\0');
+    ASSERT_EQ(expected.size(), pread(fd, actual.data(), actual.size(), 0));
+    close(fd);
+
+    EXPECT_EQ(expected, actual);
+}
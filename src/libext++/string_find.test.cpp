@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <ext/string.h>
+
+#include <random>
+
+using namespace std::literals;
+
+TEST(StringFind, Basic) {
+    constexpr auto haystack = "the quick brown fox jumps over the lazy dog"sv;
+
+    EXPECT_EQ(4, ext::find(haystack, "quick"));
+    EXPECT_EQ(31, ext::find(haystack, "the", 1));
+    EXPECT_EQ(40, ext::find(haystack, "dog"));
+    EXPECT_EQ(std::string_view::npos, ext::find(haystack, "cat"));
+    EXPECT_EQ(std::string_view::npos, ext::find(haystack, "dogs"));
+    EXPECT_EQ(0, ext::find(haystack, ""));
+    EXPECT_EQ(std::string_view::npos, ext::find("", "a"));
+    EXPECT_EQ(std::string_view::npos, ext::find(haystack, "o", 100));
+}
+
+TEST(StringFind, MatchesStandard) {
+    auto engine = std::mt19937(42);
+    auto letter = std::uniform_int_distribution<int>('a', 'c');
+    auto length = std::uniform_int_distribution<std::size_t>(1, 6);
+
+    auto haystack = std::string(500, '\0');
+    for (auto& c : haystack) c = static_cast<char>(letter(engine));
+
+    for (auto i = 0; i < 200; ++i) {
+        auto needle = std::string(length(engine), '\0');
+        for (auto& c : needle) c = static_cast<char>(letter(engine));
+
+        for (auto pos = 0ul; pos <= haystack.size(); pos += 37) {
+            ASSERT_EQ(
+                std::string_view(haystack).find(needle, pos),
+                ext::find(haystack, needle, pos)
+            ) << "needle: " << needle << ", pos: " << pos;
+        }
+    }
+}
+
+TEST(StringFind, All) {
+    constexpr auto haystack = "aaaa-ab-aaa"sv;
+    const auto matches = ext::find_all(haystack, "aa");
+
+    EXPECT_EQ(
+        (std::vector<std::size_t> {0, 2, 8}),
+        std::vector<std::size_t>(matches.begin(), matches.end())
+    );
+    EXPECT_EQ(3, std::ranges::distance(matches));
+}
+
+TEST(StringFind, AllNoMatches) {
+    const auto matches = ext::find_all("abc", "d");
+    EXPECT_EQ(matches.end(), matches.begin());
+
+    const auto empty = ext::find_all("abc", "");
+    EXPECT_EQ(empty.end(), empty.begin());
+}
+
+TEST(StringFind, AllLong) {
+    auto haystack = std::string();
+    for (auto i = 0; i < 1000; ++i) haystack += "lorem ipsum dolor ";
+
+    auto count = 0;
+    for (const auto pos : ext::find_all(haystack, "ipsum")) {
+        ASSERT_EQ("ipsum", haystack.substr(pos, 5));
+        ++count;
+    }
+
+    EXPECT_EQ(1000, count);
+}
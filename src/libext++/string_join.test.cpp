@@ -0,0 +1,64 @@
+#include <ext/string.h>
+
+#include <gtest/gtest.h>
+#include <list>
+
+using namespace std::literals;
+
+TEST(StringJoin, Empty) {
+    const auto elements = std::vector<std::string>();
+    EXPECT_EQ(""s, ext::join(elements, ", "));
+}
+
+TEST(StringJoin, Single) {
+    const auto elements = std::vector<std::string> {"foo"};
+    EXPECT_EQ("foo"s, ext::join(elements, ", "));
+}
+
+TEST(StringJoin, Strings) {
+    const auto elements = std::vector<std::string_view> {"foo", "bar", "baz"};
+    EXPECT_EQ("foo, bar, baz"s, ext::join(elements, ", "sv));
+}
+
+TEST(StringJoin, Numbers) {
+    const auto integers = std::list<int> {1, -2, 3};
+    EXPECT_EQ("1:-2:3"s, ext::join(integers, ":"));
+
+    const auto floats = std::vector<double> {0.5, 1.25};
+    EXPECT_EQ("0.5 1.25"s, ext::join(floats, " "));
+}
+
+TEST(StringJoin, Projection) {
+    struct item {
+        std::string name;
+        int id;
+    };
+
+    const auto items = std::vector<item> {{"foo", 1}, {"bar", 2}};
+
+    EXPECT_EQ("foo/bar"s, ext::join(items, "/", &item::name));
+    EXPECT_EQ("1/2"s, ext::join(items, "/", &item::id));
+}
+
+TEST(StringJoin, InputRange) {
+    auto stream = std::istringstream("one two three");
+    auto words = std::views::istream<std::string>(stream);
+
+    EXPECT_EQ("one,two,three"s, ext::join(words, ","));
+}
+
+TEST(StringJoin, Append) {
+    const auto elements = std::array {"b"sv, "c"sv};
+    auto result = "a="s;
+
+    ext::join_to(result, elements, "+");
+    EXPECT_EQ("a=b+c"s, result);
+}
+
+TEST(StringJoin, OutputIterator) {
+    const auto elements = std::array {1, 2, 3};
+    auto result = std::vector<char>();
+
+    ext::join_to(std::back_inserter(result), elements, "-");
+    EXPECT_EQ("1-2-3"s, std::string(result.begin(), result.end()));
+}
@@ -83,3 +83,62 @@ TEST(StringSplit, Loop) {
         ASSERT_EQ(array[index++], token);
     }
 }
+
+TEST(StringSplit, AnyOf) {
+    constexpr auto seq = "one two\tthree,four";
+    const auto tokens = ext::split(seq, ext::charset(" \t,"));
+
+    ASSERT_EQ(
+        (std::vector<std::string_view> {"one", "two", "three", "four"}),
+        tokens
+    );
+}
+
+TEST(StringSplit, AnyOfKeepsEmpty) {
+    constexpr auto seq = ",a;;b,";
+    const auto tokens = ext::split(seq, ext::charset(",;"));
+
+    ASSERT_EQ(
+        (std::vector<std::string_view> {"", "a", "", "b", ""}),
+        tokens
+    );
+}
+
+TEST(StringSplit, AnyOfCollapse) {
+    constexpr auto seq = " a \t b  ";
+    const auto tokens = ext::split(seq, ext::whitespace, {.collapse = true});
+
+    ASSERT_EQ((std::vector<std::string_view> {"", "a", "b", ""}), tokens);
+}
+
+TEST(StringSplit, AnyOfSkipEmpty) {
+    constexpr auto seq = "\n\n first  second\r\nthird \n";
+    const auto tokens =
+        ext::split(seq, ext::whitespace, {.skip_empty = true});
+
+    ASSERT_EQ(
+        (std::vector<std::string_view> {"first", "second", "third"}),
+        tokens
+    );
+}
+
+TEST(StringSplit, AnyOfOnlyDelimiters) {
+    constexpr auto options = ext::split_options {.skip_empty = true};
+    auto range = ext::string_range(" \t ", ext::whitespace, options);
+
+    ASSERT_EQ(range.end(), range.begin());
+    ASSERT_TRUE(ext::split("", ext::whitespace, options).empty());
+}
+
+TEST(StringSplit, StringCollapse) {
+    constexpr auto seq = "a::b::::c::";
+
+    ASSERT_EQ(
+        (std::vector<std::string_view> {"a", "b", "c", ""}),
+        ext::split(seq, "::", {.collapse = true})
+    );
+    ASSERT_EQ(
+        (std::vector<std::string_view> {"a", "b", "c"}),
+        ext::split(seq, "::", {.skip_empty = true})
+    );
+}
@@ -21,3 +21,31 @@ TEST(StringTrim, TrimEnd) {
     EXPECT_EQ("foo bar"sv, ext::trim_end("foo bar "));
     EXPECT_EQ(" foo"sv, ext::trim_end(" foo "));
 }
+
+TEST(StringTrim, Trim) {
+    EXPECT_EQ("foo"sv, ext::trim("  foo \r\n"));
+    EXPECT_EQ("foo bar"sv, ext::trim("\tfoo bar\v\f"));
+    EXPECT_EQ(""sv, ext::trim(" \t\n "));
+    EXPECT_EQ(""sv, ext::trim(""));
+}
+
+TEST(StringTrim, LongRuns) {
+    const auto padding = std::string(37, ' ') + "\t\n" + std::string(20, ' ');
+    const auto string = padding + "foo bar" + padding;
+
+    EXPECT_EQ("foo bar"sv, ext::trim(string));
+    EXPECT_EQ("foo bar" + padding, ext::trim_start(string));
+    EXPECT_EQ(padding + "foo bar", ext::trim_end(string));
+    EXPECT_EQ(""sv, ext::trim(padding + padding));
+}
+
+TEST(StringTrim, NonAscii) {
+    EXPECT_EQ("\xa0" "foo\x85"sv, ext::trim(" \xa0" "foo\x85 "));
+}
+
+TEST(StringTrim, Charset) {
+    EXPECT_EQ("foo"sv, ext::trim("--foo__", "-_"));
+    EXPECT_EQ("foo__"sv, ext::trim_start("--foo__", "-_"));
+    EXPECT_EQ("--foo"sv, ext::trim_end("--foo__", "-_"));
+    EXPECT_EQ(" foo "sv, ext::trim("\" foo \"", "\""));
+}
@@ -0,0 +1,141 @@
+#include <ext/thread_pool>
+
+namespace {
+    /**
+     * The number of times an idle worker looks for work before it sleeps.
+     */
+    constexpr auto spin_rounds = 64;
+
+    struct worker_identity {
+        const ext::thread_pool* pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    thread_local auto current = worker_identity();
+}
+
+namespace ext {
+    thread_pool::thread_pool(unsigned int threads) {
+        if (threads == 0) threads = 1;
+
+        workers.reserve(threads);
+        for (auto i = 0u; i < threads; ++i) {
+            workers.push_back(std::make_unique<worker>());
+        }
+
+        this->threads.reserve(threads);
+        for (auto i = 0u; i < threads; ++i) {
+            this->threads.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    thread_pool::~thread_pool() {
+        {
+            const auto lock = std::lock_guard(mutex);
+            stopping.store(true);
+            ++epoch;
+        }
+
+        wakeup.notify_all();
+        threads.clear();
+    }
+
+    auto thread_pool::find_work(std::size_t index) -> std::coroutine_handle<> {
+        if (const auto local = workers[index]->deque.pop()) return *local;
+
+        {
+            const auto lock = std::lock_guard(mutex);
+
+            if (!injected.empty()) {
+                const auto coroutine = injected.front();
+                injected.pop_front();
+                return coroutine;
+            }
+        }
+
+        // Try every other worker once, starting with the next one so that
+        // thieves spread out over their victims.
+        const auto count = workers.size();
+
+        for (auto i = 1ul; i < count; ++i) {
+            auto& victim = workers[(index + i) % count]->deque;
+            if (const auto stolen = victim.steal()) return *stolen;
+        }
+
+        return nullptr;
+    }
+
+    auto thread_pool::post(std::coroutine_handle<> coroutine) -> void {
+        if (current.pool == this) {
+            workers[current.index]->deque.push(coroutine);
+        }
+        else {
+            const auto lock = std::lock_guard(mutex);
+            injected.push_back(coroutine);
+        }
+
+        wake();
+    }
+
+    auto thread_pool::run(std::size_t index) -> void {
+        current = {.pool = this, .index = index};
+
+        while (!stopping.load(std::memory_order_relaxed)) {
+            auto coroutine = std::coroutine_handle<>();
+
+            for (auto i = 0; i < spin_rounds && !coroutine; ++i) {
+                coroutine = find_work(index);
+                if (!coroutine) std::this_thread::yield();
+            }
+
+            if (coroutine) {
+                coroutine.resume();
+                continue;
+            }
+
+            // Announce the intent to sleep before looking for work one last
+            // time. A thread that posts work after this check sees the
+            // sleeper and advances the epoch, so the wakeup is not lost.
+            auto lock = std::unique_lock(mutex);
+            const auto seen = epoch;
+            lock.unlock();
+
+            sleeping.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if ((coroutine = find_work(index))) {
+                sleeping.fetch_sub(1);
+                coroutine.resume();
+                continue;
+            }
+
+            lock.lock();
+            wakeup.wait(lock, [&] {
+                return epoch != seen || stopping.load();
+            });
+            lock.unlock();
+
+            sleeping.fetch_sub(1);
+        }
+    }
+
+    auto thread_pool::schedule() noexcept -> schedule_awaiter {
+        return schedule_awaiter(*this);
+    }
+
+    auto thread_pool::size() const noexcept -> std::size_t {
+        return workers.size();
+    }
+
+    auto thread_pool::wake() -> void {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load() == 0) return;
+
+        {
+            const auto lock = std::lock_guard(mutex);
+            ++epoch;
+        }
+
+        wakeup.notify_one();
+    }
+}
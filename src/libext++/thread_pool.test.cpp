@@ -0,0 +1,152 @@
+#include <ext/coroutine>
+#include <ext/thread_pool>
+
+#include <gtest/gtest.h>
+#include <latch>
+#include <set>
+
+TEST(WorkStealingDeque, Owner) {
+    auto deque = ext::detail::work_stealing_deque<int>(2);
+
+    EXPECT_TRUE(deque.empty());
+    EXPECT_FALSE(deque.pop());
+
+    // Pushing more items than the initial capacity grows the buffer.
+    for (auto i = 0; i < 10; ++i) deque.push(i);
+
+    EXPECT_FALSE(deque.empty());
+    EXPECT_EQ(0, deque.steal());
+    EXPECT_EQ(9, deque.pop());
+    EXPECT_EQ(1, deque.steal());
+    EXPECT_EQ(8, deque.pop());
+}
+
+TEST(WorkStealingDeque, Concurrent) {
+    constexpr auto count = 100'000;
+
+    auto deque = ext::detail::work_stealing_deque<int>();
+    auto done = std::atomic<bool>(false);
+    auto taken = std::vector<std::vector<int>>(4);
+
+    {
+        auto thieves = std::vector<std::jthread>();
+
+        for (auto i = 1ul; i < taken.size(); ++i) {
+            thieves.emplace_back([&, i] {
+                while (!done.load() || !deque.empty()) {
+                    if (const auto item = deque.steal()) {
+                        taken[i].push_back(*item);
+                    }
+                }
+            });
+        }
+
+        for (auto i = 0; i < count; ++i) {
+            deque.push(i);
+
+            if (i % 3 == 0) {
+                if (const auto item = deque.pop()) taken[0].push_back(*item);
+            }
+        }
+
+        while (const auto item = deque.pop()) taken[0].push_back(*item);
+        done.store(true);
+    }
+
+    auto all = std::set<int>();
+    auto total = 0ul;
+
+    for (const auto& items : taken) {
+        all.insert(items.begin(), items.end());
+        total += items.size();
+    }
+
+    EXPECT_EQ(count, total);
+    EXPECT_EQ(count, all.size());
+}
+
+TEST(ThreadPool, Schedule) {
+    auto pool = ext::thread_pool(2);
+    const auto caller = std::this_thread::get_id();
+
+    const auto hop = [&]() -> ext::task<std::thread::id> {
+        co_await pool.schedule();
+        co_return std::this_thread::get_id();
+    };
+
+    EXPECT_EQ(2, pool.size());
+    EXPECT_NE(caller, ext::sync_wait(hop()));
+}
+
+TEST(ThreadPool, FanOut) {
+    constexpr auto tasks = 10'000;
+
+    auto pool = ext::thread_pool(4);
+    auto completed = std::atomic<int>(0);
+    auto threads = std::mutex();
+    auto ids = std::set<std::thread::id>();
+    auto latch = std::latch(tasks);
+
+    const auto leaf = [&]() -> ext::detached_task {
+        co_await pool.schedule();
+
+        {
+            const auto lock = std::lock_guard(threads);
+            ids.insert(std::this_thread::get_id());
+        }
+
+        ++completed;
+        latch.count_down();
+    };
+
+    // Spawning from a worker pushes onto that worker's own deque, from
+    // which idle workers steal.
+    const auto root = [&]() -> ext::task<> {
+        co_await pool.schedule();
+        for (auto i = 0; i < tasks; ++i) leaf();
+    };
+
+    ext::sync_wait(root());
+    latch.wait();
+
+    EXPECT_EQ(tasks, completed.load());
+    EXPECT_FALSE(ids.contains(std::this_thread::get_id()));
+}
+
+TEST(ThreadPool, SyncWaitException) {
+    auto pool = ext::thread_pool(1);
+
+    const auto fail = [&]() -> ext::task<int> {
+        co_await pool.schedule();
+        throw std::runtime_error("failure");
+    };
+
+    EXPECT_THROW(ext::sync_wait(fail()), std::runtime_error);
+}
+
+TEST(ThreadPool, SyncWaitJtask) {
+    auto pool = ext::thread_pool(1);
+
+    const auto compute = [&]() -> ext::jtask<int> {
+        co_await pool.schedule();
+        co_return 42;
+    };
+
+    auto task = compute();
+    EXPECT_EQ(42, ext::sync_wait(task));
+}
+
+TEST(ThreadPool, Idle) {
+    auto pool = ext::thread_pool(4);
+
+    const auto hop = [&]() -> ext::task<int> {
+        co_await pool.schedule();
+        co_return 1;
+    };
+
+    // Workers go to sleep between bursts and must wake for new work.
+    for (auto i = 0; i < 20; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_EQ(1, ext::sync_wait(hop()));
+    }
+}
@@ -1,50 +1,517 @@
+#include <ext/child_monitor>
+#include <ext/event_loop>
 #include <ext/except.h>
 #include <ext/unix.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <dirent.h>
+#include <exception>
+#include <fcntl.h>
 #include <fmt/format.h>
 #include <grp.h>
+#include <iterator>
+#include <mutex>
 #include <pwd.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <tuple>
 #include <unistd.h>
 
+extern char** environ;
+
 namespace {
-    constexpr auto default_buffer_length = 1024;
-}
+    constexpr auto default_buffer_length = std::size_t(1024);
+    constexpr auto max_buffer_length = std::size_t(1024 * 1024);
 
-namespace ext {
-    group::group(std::variant<gid_t, std::string> value) {
-        auto buflen = sysconf(_SC_GETGR_R_SIZE_MAX);
-        if (buflen == -1) buflen = default_buffer_length;
+    /**
+     * Calls one of the reentrant user or group database functions with a
+     * buffer that is doubled each time the function reports that the entry
+     * does not fit.
+     *
+     * The initial size is a hint from sysconf, which may be -1 or simply too
+     * small for entries such as groups with many members.
+     */
+    template <typename F>
+    auto read_entry(std::unique_ptr<char[]>& buffer, long hint, F&& function)
+        -> int {
+        auto buflen = hint > 0 ? std::size_t(hint) : default_buffer_length;
 
-        buffer = std::unique_ptr<char[]>(new char[buflen]);
+        while (true) {
+            buffer = std::unique_ptr<char[]>(new char[buflen]);
 
-        auto ret = 0;
-        ::group* result = nullptr;
+            const auto ret = function(buffer.get(), buflen);
+            if (ret != ERANGE || buflen >= max_buffer_length) return ret;
 
-        if (auto* gid = std::get_if<gid_t>(&value)) {
-            ret = getgrgid_r(*gid, &data, buffer.get(), buflen, &result);
+            buflen *= 2;
         }
-        else if (auto* group_name = std::get_if<std::string>(&value)) {
-            ret = getgrnam_r(
-                group_name->c_str(),
-                &data,
-                buffer.get(),
-                buflen,
-                &result
-            );
+    }
+
+    /**
+     * A null-terminated array of C strings stored in a single buffer, as
+     * expected by the exec family of functions.
+     */
+    class string_array {
+        std::unique_ptr<char[]> buffer;
+        char* cursor;
+        std::vector<char*> pointers = {nullptr};
+    public:
+        /**
+         * Creates an empty array with room for 'count' strings with a total
+         * length of 'size', not counting null terminators.
+         */
+        string_array(std::size_t count, std::size_t size) :
+            buffer(new char[size + count]),
+            cursor(buffer.get()) {
+            pointers.reserve(count + 1);
         }
 
+        /**
+         * Appends a string formed by concatenating the given parts.
+         */
+        template <typename... Parts>
+        auto add(const Parts&... parts) -> void {
+            pointers.back() = cursor;
+            pointers.push_back(nullptr);
+
+            (..., (cursor = std::ranges::copy(std::string_view(parts), cursor)
+                                .out));
+            *cursor++ = '\0';
+        }
+
+        auto get() noexcept -> char** { return pointers.data(); }
+    };
+
+    auto make_argv(
+        std::string_view program,
+        std::span<const std::string_view> args
+    ) -> string_array {
+        auto size = program.size();
+        for (const auto arg : args) size += arg.size();
+
+        auto argv = string_array(args.size() + 1, size);
+
+        argv.add(program);
+        for (const auto arg : args) argv.add(arg);
+
+        return argv;
+    }
+
+    auto make_envp(const ext::string_map& environment) -> string_array {
+        auto size = std::size_t();
+        for (const auto& [key, value] : environment) {
+            size += key.size() + value.size() + 1;
+        }
+
+        auto envp = string_array(environment.size(), size);
+        for (const auto& [key, value] : environment) envp.add(key, "=", value);
+
+        return envp;
+    }
+
+    /**
+     * Throws an exception for an error number returned by a posix_spawn
+     * function.
+     */
+    auto check_spawn(int ret, std::string_view message) -> void {
         if (ret != 0) {
-            std::visit(
-                [ret](auto&& arg) -> void {
-                    throw std::system_error(
-                        ret,
-                        std::generic_category(),
-                        fmt::format("failed to look up group ({})", arg)
-                    );
-                },
-                value
+            throw std::system_error(
+                ret,
+                std::generic_category(),
+                std::string(message)
+            );
+        }
+    }
+
+    auto wait_for(pid_t pid, std::error_code& ec) noexcept
+        -> ext::exit_status {
+        auto info = siginfo_t();
+
+        while (waitid(P_PID, pid, &info, WEXITED) == -1) {
+            if (errno == EINTR) continue;
+
+            ec = std::error_code(errno, std::generic_category());
+            return {};
+        }
+
+        ec.clear();
+        return {.code = info.si_code, .status = info.si_status};
+    }
+
+    auto wait_for(pid_t pid) -> ext::exit_status {
+        auto ec = std::error_code();
+        const auto status = wait_for(pid, ec);
+
+        if (ec) throw ext::system_error(ec, "Failed to wait for child process");
+        return status;
+    }
+
+    auto wait_for(pid_t pid, ext::resource_usage& usage) -> ext::exit_status {
+        auto status = 0;
+        auto ru = rusage();
+
+        while (wait4(pid, &status, 0, &ru) == -1) {
+            if (errno == EINTR) continue;
+            throw ext::system_error("Failed to wait for child process");
+        }
+
+        const auto microseconds = [](const timeval& time) {
+            return std::chrono::seconds(time.tv_sec) +
+                   std::chrono::microseconds(time.tv_usec);
+        };
+
+        usage = {
+            .user_time = microseconds(ru.ru_utime),
+            .system_time = microseconds(ru.ru_stime),
+            // Linux reports the peak in kilobytes.
+            .max_rss = std::uint64_t(ru.ru_maxrss) * 1024,
+            .minor_faults = std::uint64_t(ru.ru_minflt),
+            .major_faults = std::uint64_t(ru.ru_majflt),
+            .voluntary_switches = std::uint64_t(ru.ru_nvcsw),
+            .involuntary_switches = std::uint64_t(ru.ru_nivcsw)
+        };
+
+        if (WIFEXITED(status)) {
+            return {.code = CLD_EXITED, .status = WEXITSTATUS(status)};
+        }
+
+        return {
+            .code = WCOREDUMP(status) ? CLD_DUMPED : CLD_KILLED,
+            .status = WTERMSIG(status)
+        };
+    }
+
+    auto wait_for(pid_t pid, ext::child_monitor& monitor)
+        -> ext::task<ext::exit_status> {
+        co_await monitor.exited(pid);
+        co_return wait_for(pid);
+    }
+
+    auto wait_for(pid_t pid, ext::event_loop& loop)
+        -> ext::task<ext::exit_status> {
+        auto monitor = ext::child_monitor(loop);
+        co_await monitor.exited(pid);
+        co_return wait_for(pid);
+    }
+
+    auto wait_for(
+        pid_t pid,
+        ext::child_monitor& monitor,
+        ext::resource_usage& usage
+    ) -> ext::task<ext::exit_status> {
+        co_await monitor.exited(pid);
+        co_return wait_for(pid, usage);
+    }
+
+    class spawn_file_actions {
+        posix_spawn_file_actions_t actions;
+    public:
+        spawn_file_actions() {
+            check_spawn(
+                posix_spawn_file_actions_init(&actions),
+                "failed to initialize spawn file actions"
+            );
+        }
+
+        spawn_file_actions(const spawn_file_actions&) = delete;
+
+        ~spawn_file_actions() { posix_spawn_file_actions_destroy(&actions); }
+
+        auto get() noexcept -> posix_spawn_file_actions_t* { return &actions; }
+    };
+
+    /**
+     * Adds actions that close every descriptor not in 'keep'.
+     */
+    auto add_close_actions(
+        posix_spawn_file_actions_t* actions,
+        std::vector<int> keep
+    ) -> void {
+        std::ranges::sort(keep);
+
+        auto next = 0;
+
+        for (const auto fd : keep) {
+            for (; next < fd; ++next) {
+                check_spawn(
+                    posix_spawn_file_actions_addclose(actions, next),
+                    "failed to add close action to spawn actions"
+                );
+            }
+
+            next = std::max(next, fd + 1);
+        }
+
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 34))
+        check_spawn(
+            posix_spawn_file_actions_addclosefrom_np(actions, next),
+            "failed to add close action to spawn actions"
+        );
+#else
+        // Without closefrom, close whichever descriptors are open now.
+        for (const auto& entry :
+             std::filesystem::directory_iterator("/proc/self/fd")) {
+            const auto fd = std::stoi(entry.path().filename());
+            if (fd < next) continue;
+
+            check_spawn(
+                posix_spawn_file_actions_addclose(actions, fd),
+                "failed to add close action to spawn actions"
+            );
+        }
+#endif
+    }
+
+    class spawn_attributes {
+        posix_spawnattr_t attributes;
+    public:
+        spawn_attributes() {
+            check_spawn(
+                posix_spawnattr_init(&attributes),
+                "failed to initialize spawn attributes"
+            );
+        }
+
+        spawn_attributes(const spawn_attributes&) = delete;
+
+        ~spawn_attributes() { posix_spawnattr_destroy(&attributes); }
+
+        auto get() noexcept -> posix_spawnattr_t* { return &attributes; }
+    };
+
+    /**
+     * A directory waiting to be walked, opened relative to its parent.
+     */
+    struct pending_directory {
+        std::shared_ptr<const ext::unique_fd> parent;
+        std::string name;
+        std::filesystem::path path;
+    };
+
+    class chown_walker {
+        static constexpr auto dirent_buffer_size = 32 * 1024;
+
+        const uid_t uid;
+        const gid_t gid;
+        const ext::chown_tree_options& options;
+
+        std::mutex mutex;
+        std::condition_variable available;
+        std::vector<pending_directory> pending;
+        unsigned int busy = 0;
+        bool stopped = false;
+        std::exception_ptr failure;
+
+        std::mutex error_mutex;
+
+        std::atomic<std::size_t> changed = 0;
+        std::atomic<std::size_t> unchanged = 0;
+        std::atomic<std::size_t> failed = 0;
+
+        auto report(std::filesystem::path path, int error) -> void {
+            ++failed;
+
+            if (!options.on_error) return;
+
+            const auto lock = std::lock_guard(error_mutex);
+            options.on_error({
+                .path = std::move(path),
+                .error = std::error_code(error, std::generic_category())
+            });
+        }
+
+        /**
+         * Changes the ownership of a single entry if it differs from the
+         * requested one. Returns true if the entry is a directory that
+         * should be walked.
+         */
+        auto visit(
+            int dirfd,
+            const char* name,
+            const std::filesystem::path& parent
+        ) -> bool {
+            struct stat st;
+
+            if (fstatat(dirfd, name, &st, AT_SYMLINK_NOFOLLOW) == -1) {
+                report(parent / name, errno);
+                return false;
+            }
+
+            const auto is_directory = S_ISDIR(st.st_mode);
+
+            if (
+                (uid == uid_t(-1) || st.st_uid == uid) &&
+                (gid == gid_t(-1) || st.st_gid == gid)
+            ) {
+                ++unchanged;
+                return is_directory;
+            }
+
+            if (fchownat(dirfd, name, uid, gid, AT_SYMLINK_NOFOLLOW) == -1) {
+                report(parent / name, errno);
+                return is_directory;
+            }
+
+            ++changed;
+            return is_directory;
+        }
+
+        auto walk(const pending_directory& directory) -> void {
+            const auto parent =
+                directory.parent ? directory.parent->get() : AT_FDCWD;
+            const auto fd = std::make_shared<ext::unique_fd>(openat(
+                parent,
+                directory.name.c_str(),
+                O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC
+            ));
+
+            if (!*fd) {
+                report(directory.path, errno);
+                return;
+            }
+
+            alignas(dirent64) char buffer[dirent_buffer_size];
+            auto subdirectories = std::vector<pending_directory>();
+
+            while (true) {
+                const auto bytes = ::syscall(
+                    SYS_getdents64,
+                    fd->get(),
+                    buffer,
+                    sizeof(buffer)
+                );
+
+                if (bytes == -1) {
+                    report(directory.path, errno);
+                    break;
+                }
+
+                if (bytes == 0) break;
+
+                for (auto offset = 0l; offset < bytes;) {
+                    const auto* const entry =
+                        reinterpret_cast<const dirent64*>(buffer + offset);
+                    offset += entry->d_reclen;
+
+                    const auto name = std::string_view(entry->d_name);
+                    if (name == "." || name == "..") continue;
+
+                    if (visit(fd->get(), entry->d_name, directory.path)) {
+                        subdirectories.push_back({
+                            .parent = fd,
+                            .name = std::string(name),
+                            .path = directory.path / name
+                        });
+                    }
+                }
+            }
+
+            if (subdirectories.empty()) return;
+
+            auto lock = std::unique_lock(mutex);
+
+            std::move(
+                subdirectories.begin(),
+                subdirectories.end(),
+                std::back_inserter(pending)
             );
+
+            lock.unlock();
+
+            if (subdirectories.size() == 1) available.notify_one();
+            else available.notify_all();
+        }
+
+        auto work() -> void {
+            auto lock = std::unique_lock(mutex);
+
+            while (true) {
+                available.wait(lock, [this] {
+                    return stopped || !pending.empty() || busy == 0;
+                });
+
+                if (stopped || pending.empty()) break;
+
+                // Walking depth first keeps the number of open directories
+                // proportional to the depth of the tree.
+                const auto directory = std::move(pending.back());
+                pending.pop_back();
+                ++busy;
+
+                lock.unlock();
+
+                try {
+                    walk(directory);
+                }
+                catch (...) {
+                    lock.lock();
+
+                    if (!failure) failure = std::current_exception();
+                    stopped = true;
+                    --busy;
+
+                    break;
+                }
+
+                lock.lock();
+                --busy;
+            }
+
+            lock.unlock();
+            available.notify_all();
         }
+    public:
+        chown_walker(
+            uid_t uid,
+            gid_t gid,
+            const ext::chown_tree_options& options
+        ) :
+            uid(uid),
+            gid(gid),
+            options(options) {}
+
+        auto run(const std::filesystem::path& root) -> ext::chown_tree_result {
+            if (visit(AT_FDCWD, root.c_str(), {})) {
+                // The root is opened relative to the working directory.
+                pending.push_back({
+                    .parent = nullptr,
+                    .name = root.native(),
+                    .path = root
+                });
+            }
+
+            {
+                auto workers = std::vector<std::jthread>();
+
+                for (auto i = 1u; i < options.threads; ++i) {
+                    workers.emplace_back([this] { work(); });
+                }
+
+                work();
+            }
+
+            if (failure) std::rethrow_exception(failure);
+
+            return {
+                .changed = changed,
+                .unchanged = unchanged,
+                .failed = failed
+            };
+        }
+    };
+}
+
+namespace ext {
+    group::group(std::variant<gid_t, std::string> value) {
+        auto result = lookup(value);
 
         if (!result) {
             std::visit(
@@ -56,6 +523,76 @@ namespace ext {
                 value
             );
         }
+
+        *this = std::move(*result);
+    }
+
+    auto group::lookup(std::variant<gid_t, std::string> value)
+        -> std::optional<group> {
+        auto ec = std::error_code();
+        auto result = lookup(value, ec);
+
+        if (ec) {
+            std::visit(
+                [&ec](auto&& arg) -> void {
+                    throw std::system_error(
+                        ec,
+                        fmt::format("failed to look up group ({})", arg)
+                    );
+                },
+                value
+            );
+        }
+
+        return result;
+    }
+
+    auto group::lookup(
+        const std::variant<gid_t, std::string>& value,
+        std::error_code& ec
+    ) noexcept -> std::optional<group> {
+        ec.clear();
+
+        try {
+            auto entry = group();
+            ::group* result = nullptr;
+
+            const auto ret = read_entry(
+                entry.buffer,
+                sysconf(_SC_GETGR_R_SIZE_MAX),
+                [&](char* buffer, std::size_t buflen) -> int {
+                    if (const auto* gid = std::get_if<gid_t>(&value)) {
+                        return getgrgid_r(
+                            *gid,
+                            &entry.data,
+                            buffer,
+                            buflen,
+                            &result
+                        );
+                    }
+
+                    return getgrnam_r(
+                        std::get<std::string>(value).c_str(),
+                        &entry.data,
+                        buffer,
+                        buflen,
+                        &result
+                    );
+                }
+            );
+
+            if (ret != 0) {
+                ec = std::error_code(ret, std::generic_category());
+                return std::nullopt;
+            }
+
+            if (!result) return std::nullopt;
+            return entry;
+        }
+        catch (const std::bad_alloc&) {
+            ec = std::make_error_code(std::errc::not_enough_memory);
+            return std::nullopt;
+        }
     }
 
     auto group::gid() const -> gid_t { return data.gr_gid; }
@@ -65,33 +602,32 @@ namespace ext {
     auto group::password() const -> std::string_view { return data.gr_passwd; }
 
     user::user(std::variant<uid_t, std::string> value) {
-        auto buflen = sysconf(_SC_GETPW_R_SIZE_MAX);
-        if (buflen == -1) buflen = default_buffer_length;
+        auto result = lookup(value);
 
-        buffer = std::unique_ptr<char[]>(new char[buflen]);
-
-        auto ret = 0;
-        passwd* result = nullptr;
-
-        if (auto* uid = std::get_if<uid_t>(&value)) {
-            ret = getpwuid_r(*uid, &data, buffer.get(), buflen, &result);
-        }
-        else if (auto* username = std::get_if<std::string>(&value)) {
-            ret = getpwnam_r(
-                username->c_str(),
-                &data,
-                buffer.get(),
-                buflen,
-                &result
+        if (!result) {
+            std::visit(
+                [](auto&& arg) -> void {
+                    throw std::runtime_error(
+                        fmt::format("user ({}) does not exist", arg)
+                    );
+                },
+                value
             );
         }
 
-        if (ret != 0) {
+        *this = std::move(*result);
+    }
+
+    auto user::lookup(std::variant<uid_t, std::string> value)
+        -> std::optional<user> {
+        auto ec = std::error_code();
+        auto result = lookup(value, ec);
+
+        if (ec) {
             std::visit(
-                [ret](auto&& arg) -> void {
+                [&ec](auto&& arg) -> void {
                     throw std::system_error(
-                        ret,
-                        std::generic_category(),
+                        ec,
                         fmt::format("failed to look up user ({})", arg)
                     );
                 },
@@ -99,15 +635,54 @@ namespace ext {
             );
         }
 
-        if (!result) {
-            std::visit(
-                [](auto&& arg) -> void {
-                    throw std::runtime_error(
-                        fmt::format("user ({}) does not exist", arg)
+        return result;
+    }
+
+    auto user::lookup(
+        const std::variant<uid_t, std::string>& value,
+        std::error_code& ec
+    ) noexcept -> std::optional<user> {
+        ec.clear();
+
+        try {
+            auto entry = user();
+            passwd* result = nullptr;
+
+            const auto ret = read_entry(
+                entry.buffer,
+                sysconf(_SC_GETPW_R_SIZE_MAX),
+                [&](char* buffer, std::size_t buflen) -> int {
+                    if (const auto* uid = std::get_if<uid_t>(&value)) {
+                        return getpwuid_r(
+                            *uid,
+                            &entry.data,
+                            buffer,
+                            buflen,
+                            &result
+                        );
+                    }
+
+                    return getpwnam_r(
+                        std::get<std::string>(value).c_str(),
+                        &entry.data,
+                        buffer,
+                        buflen,
+                        &result
                     );
-                },
-                value
+                }
             );
+
+            if (ret != 0) {
+                ec = std::error_code(ret, std::generic_category());
+                return std::nullopt;
+            }
+
+            if (!result) return std::nullopt;
+            return entry;
+        }
+        catch (const std::bad_alloc&) {
+            ec = std::make_error_code(std::errc::not_enough_memory);
+            return std::nullopt;
         }
     }
 
@@ -134,6 +709,18 @@ namespace ext {
         }
     }
 
+    auto chown(
+        const std::filesystem::path& path,
+        uid_t uid,
+        gid_t gid,
+        std::error_code& ec
+    ) noexcept -> void {
+        if (::chown(path.c_str(), uid, gid) == -1) {
+            ec = std::error_code(errno, std::generic_category());
+        }
+        else ec.clear();
+    }
+
     auto chown(const std::filesystem::path& path, const user& owner) -> void {
         chown(path, owner.uid(), -1);
     }
@@ -160,33 +747,378 @@ namespace ext {
         else if (group) chown(path, *group);
     }
 
+    auto chown_tree(
+        const std::filesystem::path& root,
+        uid_t uid,
+        gid_t gid,
+        const chown_tree_options& options
+    ) -> chown_tree_result {
+        return chown_walker(uid, gid, options).run(root);
+    }
+
+    auto chown_tree(
+        const std::filesystem::path& root,
+        const std::optional<user>& owner,
+        const std::optional<group>& group,
+        const chown_tree_options& options
+    ) -> chown_tree_result {
+        return chown_tree(
+            root,
+            owner ? owner->uid() : uid_t(-1),
+            group ? group->gid() : gid_t(-1),
+            options
+        );
+    }
+
+    unique_fd::unique_fd(int fd) noexcept : fd(fd) {}
+
+    unique_fd::unique_fd(unique_fd&& other) noexcept :
+        fd(std::exchange(other.fd, -1)) {}
+
+    unique_fd::~unique_fd() { reset(); }
+
+    auto unique_fd::operator=(unique_fd&& other) noexcept -> unique_fd& {
+        if (std::addressof(other) != this) reset(other.release());
+        return *this;
+    }
+
+    unique_fd::operator bool() const noexcept { return fd != -1; }
+
+    auto unique_fd::get() const noexcept -> int { return fd; }
+
+    auto unique_fd::release() noexcept -> int { return std::exchange(fd, -1); }
+
+    auto unique_fd::reset(int fd) noexcept -> void {
+        if (this->fd != -1) close(this->fd);
+        this->fd = fd;
+    }
+
+    auto open_pipe() -> pipe_fds {
+        int fds[2];
+
+        if (pipe2(fds, O_CLOEXEC) == -1) {
+            throw ext::system_error("failed to create pipe");
+        }
+
+        return {.read = unique_fd(fds[0]), .write = unique_fd(fds[1])};
+    }
+
+    auto splice(int in, int out, std::size_t length, unsigned int flags)
+        -> std::size_t {
+        while (true) {
+            const auto moved =
+                ::splice(in, nullptr, out, nullptr, length, flags);
+
+            if (moved >= 0) return moved;
+            if (errno != EINTR) throw ext::system_error("failed to splice");
+        }
+    }
+
+    auto splice_all(int in, int out) -> std::size_t {
+        constexpr auto chunk_size = std::size_t(1) << 20;
+
+        auto total = std::size_t();
+
+        while (const auto moved = splice(in, out, chunk_size, SPLICE_F_MOVE)) {
+            total += moved;
+        }
+
+        return total;
+    }
+
+    auto tee(int in, int out, std::size_t length, unsigned int flags)
+        -> std::size_t {
+        while (true) {
+            const auto duplicated = ::tee(in, out, length, flags);
+
+            if (duplicated >= 0) return duplicated;
+            if (errno != EINTR) throw ext::system_error("failed to tee");
+        }
+    }
+
+    fd_reader::fd_reader(int fd, std::size_t buffer_size) :
+        fd(fd),
+        buffer(new char[std::max(buffer_size, std::size_t(1))]),
+        capacity(std::max(buffer_size, std::size_t(1))) {}
+
+    auto fd_reader::fill() -> void {
+        // Make room at the end of the buffer: first by discarding consumed
+        // input, then by growing it if it is full of unconsumed input.
+        if (last == capacity) {
+            if (first > 0) {
+                std::memmove(buffer.get(), buffer.get() + first, last - first);
+                last -= first;
+                first = 0;
+            }
+            else {
+                auto larger = std::unique_ptr<char[]>(new char[capacity * 2]);
+                std::memcpy(larger.get(), buffer.get(), last);
+                buffer = std::move(larger);
+                capacity *= 2;
+            }
+        }
+
+        while (true) {
+            const auto bytes = ::read(fd, buffer.get() + last, capacity - last);
+
+            if (bytes > 0) {
+                last += bytes;
+                return;
+            }
+
+            if (bytes == 0) {
+                eof = true;
+                return;
+            }
+
+            if (errno != EINTR) throw ext::system_error("failed to read");
+        }
+    }
+
+    auto fd_reader::read() -> std::string_view {
+        if (first == last && !eof) {
+            first = 0;
+            last = 0;
+            fill();
+        }
+
+        const auto result =
+            std::string_view(buffer.get() + first, last - first);
+
+        first = last;
+        return result;
+    }
+
+    auto fd_reader::lines() -> generator<std::string_view> {
+        auto searched = first;
+
+        while (true) {
+            const auto* const begin = buffer.get() + first;
+            const auto* const newline = static_cast<const char*>(
+                std::memchr(buffer.get() + searched, '\n', last - searched)
+            );
+
+            if (newline) {
+                first = newline + 1 - buffer.get();
+                searched = first;
+                co_yield std::string_view(begin, newline - begin);
+                continue;
+            }
+
+            if (eof) {
+                if (first != last) {
+                    const auto size = last - first;
+                    first = last;
+                    co_yield std::string_view(begin, size);
+                }
+
+                co_return;
+            }
+
+            const auto consumed = first;
+            searched = last;
+
+            fill();
+
+            // Filling the buffer may have moved the unconsumed input to the
+            // front.
+            searched -= consumed - first;
+        }
+    }
+
     auto exec(std::string_view program, std::span<const std::string_view> args)
         -> void {
-        auto argv = std::unique_ptr<char*[]>(new char*[args.size() + 2]);
+        auto ec = std::error_code();
+        exec(program, args, ec);
 
-        auto program_str = std::string(program);
-        argv[0] = program_str.data();
+        throw ext::system_error(
+            ec,
+            fmt::format("Failed to execute '{}' command", program)
+        );
+    }
 
-        argv[args.size() + 1] = nullptr;
+    auto exec(
+        std::string_view program,
+        std::span<const std::string_view> args,
+        std::error_code& ec
+    ) noexcept -> void {
+        try {
+            auto argv = make_argv(program, args);
 
-        auto args_vec = std::vector<std::unique_ptr<char[]>>();
+            execvp(argv.get()[0], argv.get());
+            ec = std::error_code(errno, std::generic_category());
+        }
+        catch (const std::bad_alloc&) {
+            ec = std::make_error_code(std::errc::not_enough_memory);
+        }
+    }
+
+    auto detail::spawn(
+        char* const* argv,
+        char* const* envp,
+        const spawn_options& options
+    ) -> process {
+        auto actions = spawn_file_actions();
+        auto result = process(0);
+
+        // The child's ends of any pipes are closed in the parent once the
+        // child has been spawned.
+        auto child_ends = std::array<unique_fd, 3>();
 
-        for (auto i = 0ul; i < args.size(); ++i) {
-            const auto& current = args[i];
-            const auto size = current.size();
+        const auto streams = std::array {
+            std::tuple {STDIN_FILENO, options.in, &result.in},
+            std::tuple {STDOUT_FILENO, options.out, &result.out},
+            std::tuple {STDERR_FILENO, options.err, &result.err}};
 
-            args_vec.emplace_back(new char[size + 1]);
-            current.copy(args_vec[i].get(), size);
-            args_vec[i][size] = '\0';
+        for (const auto& [fd, mode, parent_end] : streams) {
+            const auto is_input = fd == STDIN_FILENO;
 
-            argv[i + 1] = args_vec[i].get();
+            switch (mode) {
+                case stdio::inherit: break;
+                case stdio::null:
+                    check_spawn(
+                        posix_spawn_file_actions_addopen(
+                            actions.get(),
+                            fd,
+                            "/dev/null",
+                            is_input ? O_RDONLY : O_WRONLY,
+                            0
+                        ),
+                        "failed to add /dev/null to spawn actions"
+                    );
+                    break;
+                case stdio::pipe: {
+                    auto [read, write] = open_pipe();
+                    auto& child_end = child_ends[fd];
+
+                    if (is_input) {
+                        child_end = std::move(read);
+                        *parent_end = std::move(write);
+                    }
+                    else {
+                        child_end = std::move(write);
+                        *parent_end = std::move(read);
+                    }
+
+                    check_spawn(
+                        posix_spawn_file_actions_adddup2(
+                            actions.get(),
+                            child_end.get(),
+                            fd
+                        ),
+                        "failed to add pipe to spawn actions"
+                    );
+                    break;
+                }
+            }
         }
 
-        if (execvp(program.data(), argv.get()) == -1) {
-            throw ext::system_error(
-                fmt::format("Failed to execute '{}' command", program)
+        for (const auto& [child, parent] : options.fds) {
+            check_spawn(
+                posix_spawn_file_actions_adddup2(actions.get(), parent, child),
+                "failed to add file descriptor to spawn actions"
             );
         }
+
+        // Duplicating a descriptor onto itself clears its close-on-exec
+        // flag in the child.
+        for (const auto fd : options.keep_fds) {
+            check_spawn(
+                posix_spawn_file_actions_adddup2(actions.get(), fd, fd),
+                "failed to add file descriptor to spawn actions"
+            );
+        }
+
+        if (options.close_fds) {
+            auto keep = std::vector<int> {
+                STDIN_FILENO,
+                STDOUT_FILENO,
+                STDERR_FILENO};
+
+            for (const auto& mapping : options.fds) {
+                keep.push_back(mapping.child);
+            }
+
+            keep.insert(
+                keep.end(),
+                options.keep_fds.begin(),
+                options.keep_fds.end()
+            );
+
+            add_close_actions(actions.get(), std::move(keep));
+        }
+
+        if (options.directory) {
+            check_spawn(
+                posix_spawn_file_actions_addchdir_np(
+                    actions.get(),
+                    options.directory->c_str()
+                ),
+                "failed to add working directory to spawn actions"
+            );
+        }
+
+        auto attributes = spawn_attributes();
+
+        auto mask = sigset_t();
+        sigemptyset(&mask);
+
+        auto defaults = sigset_t();
+        sigfillset(&defaults);
+
+        check_spawn(
+            posix_spawnattr_setflags(
+                attributes.get(),
+                POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF
+            ),
+            "failed to set spawn flags"
+        );
+        check_spawn(
+            posix_spawnattr_setsigmask(attributes.get(), &mask),
+            "failed to set spawn signal mask"
+        );
+        check_spawn(
+            posix_spawnattr_setsigdefault(attributes.get(), &defaults),
+            "failed to set spawn signal defaults"
+        );
+
+        auto pid = pid_t();
+
+        const auto ret = posix_spawnp(
+            &pid,
+            argv[0],
+            actions.get(),
+            attributes.get(),
+            argv,
+            envp ? envp : environ
+        );
+
+        // Only format the message if it is needed.
+        if (ret != 0) {
+            check_spawn(
+                ret,
+                fmt::format("Failed to execute '{}' command", argv[0])
+            );
+        }
+
+        result._pid = pid;
+        return result;
+    }
+
+    auto spawn(
+        std::string_view program,
+        std::span<const std::string_view> args,
+        const spawn_options& options
+    ) -> process {
+        auto argv = make_argv(program, args);
+        auto envp = std::optional<string_array>();
+        if (options.environment) envp = make_envp(*options.environment);
+
+        return detail::spawn(
+            argv.get(),
+            envp ? envp->get() : nullptr,
+            options
+        );
     }
 
     process::process(pid_t pid) : _pid(pid) {}
@@ -202,27 +1134,80 @@ namespace ext {
         return {};
     }
 
+    auto process::async_wait(child_monitor& monitor) const
+        -> task<exit_status> {
+        // The task refers only to the process ID, so it remains valid if
+        // this object is destroyed before the task completes.
+        return wait_for(_pid, monitor);
+    }
+
+    auto process::async_wait(event_loop& loop) const -> task<exit_status> {
+        return wait_for(_pid, loop);
+    }
+
+    auto process::async_wait(
+        child_monitor& monitor,
+        resource_usage& usage
+    ) const -> task<exit_status> {
+        return wait_for(_pid, monitor, usage);
+    }
+
     auto process::pid() const -> pid_t { return _pid; }
 
-    auto process::wait() const -> exit_status {
-        auto info = siginfo_t();
+    auto process::stdin_fd() noexcept -> unique_fd& { return in; }
 
-        if (waitid(P_PID, _pid, &info, WEXITED) == -1) {
-            throw ext::system_error("Failed to wait for child process");
+    auto process::stdout_fd() noexcept -> unique_fd& { return out; }
+
+    auto process::stderr_fd() noexcept -> unique_fd& { return err; }
+
+    auto process::wait() const -> exit_status { return wait_for(_pid); }
+
+    auto process::wait(std::error_code& ec) const noexcept -> exit_status {
+        return wait_for(_pid, ec);
+    }
+
+    auto process::wait(resource_usage& usage) const -> exit_status {
+        return wait_for(_pid, usage);
+    }
+
+    auto resource_usage::operator+=(const resource_usage& other)
+        -> resource_usage& {
+        user_time += other.user_time;
+        system_time += other.system_time;
+        max_rss = std::max(max_rss, other.max_rss);
+        minor_faults += other.minor_faults;
+        major_faults += other.major_faults;
+        voluntary_switches += other.voluntary_switches;
+        involuntary_switches += other.involuntary_switches;
+
+        return *this;
+    }
+
+    auto environment() -> string_map {
+        auto result = string_map();
+
+        for (auto** it = environ; *it; ++it) {
+            const auto variable = std::string_view(*it);
+            const auto separator = variable.find('=');
+
+            // Entries without a separator are not valid variables. If a name
+            // appears twice, the first entry wins, as it does for getenv.
+            if (separator == std::string_view::npos) continue;
+
+            result.try_emplace(
+                std::string(variable.substr(0, separator)),
+                std::string(variable.substr(separator + 1))
+            );
         }
 
-        return {.code = info.si_code, .status = info.si_status};
+        return result;
     }
 
     auto exec_bg(
         std::string_view program,
         std::span<const std::string_view> args
     ) -> process {
-        const auto parent = process::fork();
-
-        if (!parent) { exec(program, args); }
-
-        return *parent;
+        return spawn(program, args);
     }
 
     auto wait_exec(
@@ -232,3 +1217,43 @@ namespace ext {
         return exec_bg(program, args).wait();
     }
 }
+
+auto fmt::formatter<ext::exit_status>::format(
+    const ext::exit_status& status,
+    format_context& ctx
+) const -> decltype(ctx.out()) {
+    switch (status.code) {
+        case CLD_EXITED:
+            return fmt::format_to(
+                ctx.out(),
+                "exited with status {}",
+                status.status
+            );
+        case CLD_KILLED:
+            return fmt::format_to(
+                ctx.out(),
+                "killed by signal {}",
+                status.status
+            );
+        case CLD_DUMPED:
+            return fmt::format_to(
+                ctx.out(),
+                "killed by signal {} (core dumped)",
+                status.status
+            );
+        case CLD_STOPPED:
+            return fmt::format_to(
+                ctx.out(),
+                "stopped by signal {}",
+                status.status
+            );
+        case CLD_CONTINUED: return fmt::format_to(ctx.out(), "continued");
+        default:
+            return fmt::format_to(
+                ctx.out(),
+                "unknown status (code {}, status {})",
+                status.code,
+                status.status
+            );
+    }
+}
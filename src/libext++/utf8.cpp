@@ -0,0 +1,435 @@
+#include <ext/string.h>
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EXT_UTF8_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+    using byte = unsigned char;
+
+    constexpr auto ascii_mask = std::uint64_t(0x8080808080808080);
+
+    auto is_ascii_scalar(const byte* it, const byte* end) noexcept -> bool {
+        auto bits = std::uint64_t();
+
+        for (; end - it >= 8; it += 8) {
+            auto word = std::uint64_t();
+            std::memcpy(&word, it, sizeof(word));
+            bits |= word;
+        }
+
+        for (; it != end; ++it) bits |= *it;
+
+        return (bits & ascii_mask) == 0;
+    }
+
+    auto length_scalar(const byte* it, const byte* end) noexcept
+        -> std::size_t {
+        auto result = std::size_t();
+
+        // Every byte except a continuation byte starts a code point.
+        for (; it != end; ++it) result += (*it & 0xc0) != 0x80;
+
+        return result;
+    }
+
+    auto validate_scalar(const byte* it, const byte* end) noexcept -> bool {
+        while (it != end) {
+            if (end - it >= 8) {
+                auto word = std::uint64_t();
+                std::memcpy(&word, it, sizeof(word));
+
+                if ((word & ascii_mask) == 0) {
+                    it += 8;
+                    continue;
+                }
+            }
+
+            const auto lead = *it;
+
+            if (lead < 0x80) {
+                ++it;
+                continue;
+            }
+
+            auto size = std::ptrdiff_t();
+            auto code_point = std::uint32_t();
+            auto min = std::uint32_t();
+
+            if ((lead & 0xe0) == 0xc0) {
+                size = 2;
+                code_point = lead & 0x1f;
+                min = 0x80;
+            }
+            else if ((lead & 0xf0) == 0xe0) {
+                size = 3;
+                code_point = lead & 0x0f;
+                min = 0x800;
+            }
+            else if ((lead & 0xf8) == 0xf0) {
+                size = 4;
+                code_point = lead & 0x07;
+                min = 0x10000;
+            }
+            else return false;
+
+            if (end - it < size) return false;
+
+            for (auto i = 1; i < size; ++i) {
+                if ((it[i] & 0xc0) != 0x80) return false;
+                code_point = (code_point << 6) | (it[i] & 0x3f);
+            }
+
+            // Reject overlong encodings, surrogates and values beyond the
+            // Unicode range.
+            if (code_point < min || code_point > 0x10ffff ||
+                (code_point >= 0xd800 && code_point <= 0xdfff)) {
+                return false;
+            }
+
+            it += size;
+        }
+
+        return true;
+    }
+
+#ifdef EXT_UTF8_AVX2
+    constexpr auto avx2_width = std::ptrdiff_t(32);
+
+    [[gnu::target("avx2")]]
+    auto is_ascii_avx2(const byte* it, const byte* end) noexcept -> bool {
+        auto bits = _mm256_setzero_si256();
+
+        for (; end - it >= avx2_width; it += avx2_width) {
+            bits = _mm256_or_si256(
+                bits,
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it))
+            );
+        }
+
+        return _mm256_movemask_epi8(bits) == 0 && is_ascii_scalar(it, end);
+    }
+
+    [[gnu::target("avx2,popcnt")]]
+    auto length_avx2(const byte* it, const byte* end) noexcept
+        -> std::size_t {
+        // Continuation bytes are exactly those less than -64 when treated
+        // as signed.
+        const auto threshold = _mm256_set1_epi8(-65);
+        auto result = std::size_t();
+
+        for (; end - it >= avx2_width; it += avx2_width) {
+            const auto bytes =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+            const auto starts = static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_cmpgt_epi8(bytes, threshold))
+            );
+
+            result += std::popcount(starts);
+        }
+
+        return result + length_scalar(it, end);
+    }
+
+    /**
+     * Validates UTF-8 32 bytes at a time using the lookup algorithm of
+     * Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per
+     * Byte". Each pair of adjacent bytes is classified with three table
+     * lookups indexed by nibbles; the tables are arranged so that the bitwise
+     * AND of the three results is nonzero exactly when the pair is invalid.
+     * Three and four byte sequences are then checked for the right number of
+     * continuation bytes.
+     */
+    class avx2_validator {
+        static constexpr std::uint8_t too_short = 1 << 0;
+        static constexpr std::uint8_t too_long = 1 << 1;
+        static constexpr std::uint8_t overlong_3 = 1 << 2;
+        static constexpr std::uint8_t too_large = 1 << 3;
+        static constexpr std::uint8_t surrogate = 1 << 4;
+        static constexpr std::uint8_t overlong_2 = 1 << 5;
+        static constexpr std::uint8_t too_large_1000 = 1 << 6;
+        static constexpr std::uint8_t overlong_4 = 1 << 6;
+        static constexpr std::uint8_t two_conts = 1 << 7;
+        static constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+        __m256i error;
+        __m256i previous;
+        __m256i previous_incomplete;
+
+        [[gnu::target("avx2")]]
+        static auto lookup(
+            __m256i indices,
+            std::uint8_t t0,
+            std::uint8_t t1,
+            std::uint8_t t2,
+            std::uint8_t t3,
+            std::uint8_t t4,
+            std::uint8_t t5,
+            std::uint8_t t6,
+            std::uint8_t t7,
+            std::uint8_t t8,
+            std::uint8_t t9,
+            std::uint8_t t10,
+            std::uint8_t t11,
+            std::uint8_t t12,
+            std::uint8_t t13,
+            std::uint8_t t14,
+            std::uint8_t t15
+        ) noexcept -> __m256i {
+            const auto table = _mm256_setr_epi8(
+                t0, t1, t2, t3, t4, t5, t6, t7,
+                t8, t9, t10, t11, t12, t13, t14, t15,
+                t0, t1, t2, t3, t4, t5, t6, t7,
+                t8, t9, t10, t11, t12, t13, t14, t15
+            );
+
+            return _mm256_shuffle_epi8(table, indices);
+        }
+
+        [[gnu::target("avx2")]]
+        static auto high_nibbles(__m256i bytes) noexcept -> __m256i {
+            return _mm256_and_si256(
+                _mm256_srli_epi16(bytes, 4),
+                _mm256_set1_epi8(0x0f)
+            );
+        }
+
+        /**
+         * Returns the input shifted right by N bytes, with the last N bytes
+         * of the previous block shifted in.
+         */
+        template <int N>
+        [[gnu::target("avx2")]]
+        static auto prev(__m256i input, __m256i previous) noexcept -> __m256i {
+            return _mm256_alignr_epi8(
+                input,
+                _mm256_permute2x128_si256(previous, input, 0x21),
+                16 - N
+            );
+        }
+
+        [[gnu::target("avx2")]]
+        static auto special_cases(__m256i input, __m256i prev1) noexcept
+            -> __m256i {
+            const auto byte_1_high = lookup(
+                high_nibbles(prev1),
+                // 0_______ ________: ASCII
+                too_long, too_long, too_long, too_long,
+                too_long, too_long, too_long, too_long,
+                // 10______ ________: continuation
+                two_conts, two_conts, two_conts, two_conts,
+                // 1100____ ________: two byte lead
+                too_short | overlong_2,
+                // 1101____ ________: two byte lead
+                too_short,
+                // 1110____ ________: three byte lead
+                too_short | overlong_3 | surrogate,
+                // 1111____ ________: four byte lead
+                too_short | too_large | too_large_1000 | overlong_4
+            );
+
+            const auto byte_1_low = lookup(
+                _mm256_and_si256(prev1, _mm256_set1_epi8(0x0f)),
+                // ____0000 ________
+                carry | overlong_3 | overlong_2 | overlong_4,
+                // ____0001 ________
+                carry | overlong_2,
+                // ____001_ ________
+                carry,
+                carry,
+                // ____0100 ________
+                carry | too_large,
+                // ____0101 ________
+                carry | too_large | too_large_1000,
+                // ____011_ ________
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                // ____1___ ________
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                // ____1101 ________
+                carry | too_large | too_large_1000 | surrogate,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000
+            );
+
+            const auto byte_2_high = lookup(
+                high_nibbles(input),
+                // ________ 0_______: ASCII
+                too_short, too_short, too_short, too_short,
+                too_short, too_short, too_short, too_short,
+                // ________ 1000____
+                too_long | overlong_2 | two_conts | overlong_3 |
+                    too_large_1000 | overlong_4,
+                // ________ 1001____
+                too_long | overlong_2 | two_conts | overlong_3 | too_large,
+                // ________ 101_____
+                too_long | overlong_2 | two_conts | surrogate | too_large,
+                too_long | overlong_2 | two_conts | surrogate | too_large,
+                // ________ 11______: lead byte
+                too_short, too_short, too_short, too_short
+            );
+
+            return _mm256_and_si256(
+                _mm256_and_si256(byte_1_high, byte_1_low),
+                byte_2_high
+            );
+        }
+
+        [[gnu::target("avx2")]]
+        static auto multibyte_lengths(
+            __m256i input,
+            __m256i previous,
+            __m256i special
+        ) noexcept -> __m256i {
+            const auto prev2 = prev<2>(input, previous);
+            const auto prev3 = prev<3>(input, previous);
+
+            // Bytes two or three positions after a three or four byte lead
+            // must be continuation bytes.
+            const auto third = _mm256_subs_epu8(
+                prev2,
+                _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80))
+            );
+            const auto fourth = _mm256_subs_epu8(
+                prev3,
+                _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80))
+            );
+            const auto must_be_continuation = _mm256_and_si256(
+                _mm256_or_si256(third, fourth),
+                _mm256_set1_epi8(static_cast<char>(0x80))
+            );
+
+            return _mm256_xor_si256(must_be_continuation, special);
+        }
+
+        /**
+         * Returns nonzero bytes where the block ends in the middle of a
+         * multibyte sequence.
+         */
+        [[gnu::target("avx2")]]
+        static auto incomplete(__m256i input) noexcept -> __m256i {
+            const auto max = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1,
+                static_cast<char>(0xf0 - 1),
+                static_cast<char>(0xe0 - 1),
+                static_cast<char>(0xc0 - 1)
+            );
+
+            return _mm256_subs_epu8(input, max);
+        }
+    public:
+        [[gnu::target("avx2")]]
+        avx2_validator() noexcept :
+            error(_mm256_setzero_si256()),
+            previous(_mm256_setzero_si256()),
+            previous_incomplete(_mm256_setzero_si256()) {}
+
+        [[gnu::target("avx2")]]
+        auto check(__m256i input) noexcept -> void {
+            if (_mm256_movemask_epi8(input) == 0) {
+                // An ASCII block cannot continue a sequence from the
+                // previous block.
+                error = _mm256_or_si256(error, previous_incomplete);
+            }
+            else {
+                const auto prev1 = prev<1>(input, previous);
+                const auto special = special_cases(input, prev1);
+
+                error = _mm256_or_si256(
+                    error,
+                    multibyte_lengths(input, previous, special)
+                );
+                previous_incomplete = incomplete(input);
+            }
+
+            previous = input;
+        }
+
+        [[gnu::target("avx2")]]
+        auto valid() const noexcept -> bool {
+            const auto result = _mm256_or_si256(error, previous_incomplete);
+            return _mm256_testz_si256(result, result);
+        }
+    };
+
+    [[gnu::target("avx2")]]
+    auto validate_avx2(const byte* it, const byte* end) noexcept -> bool {
+        auto validator = avx2_validator();
+
+        for (; end - it >= avx2_width; it += avx2_width) {
+            validator.check(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it))
+            );
+        }
+
+        if (it != end) {
+            // Pad the final block with ASCII, which completes no sequence.
+            byte block[avx2_width] = {};
+            std::memcpy(block, it, end - it);
+
+            validator.check(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block))
+            );
+        }
+
+        return validator.valid();
+    }
+
+    auto detect_avx2() noexcept -> bool {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }
+
+    const auto has_avx2 = detect_avx2();
+#endif
+
+    auto bytes(std::string_view string) noexcept
+        -> std::pair<const byte*, const byte*> {
+        const auto* const begin = reinterpret_cast<const byte*>(string.data());
+        return {begin, begin + string.size()};
+    }
+}
+
+namespace ext::utf8 {
+    auto is_ascii(std::string_view string) noexcept -> bool {
+        const auto [begin, end] = bytes(string);
+
+#ifdef EXT_UTF8_AVX2
+        if (has_avx2) return is_ascii_avx2(begin, end);
+#endif
+
+        return is_ascii_scalar(begin, end);
+    }
+
+    auto length(std::string_view string) noexcept -> std::size_t {
+        const auto [begin, end] = bytes(string);
+
+#ifdef EXT_UTF8_AVX2
+        if (has_avx2) return length_avx2(begin, end);
+#endif
+
+        return length_scalar(begin, end);
+    }
+
+    auto validate(std::string_view string) noexcept -> bool {
+        const auto [begin, end] = bytes(string);
+
+#ifdef EXT_UTF8_AVX2
+        if (has_avx2) return validate_avx2(begin, end);
+#endif
+
+        return validate_scalar(begin, end);
+    }
+}
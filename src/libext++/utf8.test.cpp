@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <ext/string.h>
+
+#include <random>
+
+using namespace std::literals;
+
+namespace {
+    /**
+     * A straightforward decoder to compare the library against.
+     */
+    auto reference_validate(std::string_view string) -> bool {
+        auto i = 0ul;
+
+        while (i < string.size()) {
+            const auto lead = static_cast<unsigned char>(string[i]);
+            auto size = 0ul;
+            auto code_point = 0u;
+
+            if (lead < 0x80) size = 1, code_point = lead;
+            else if (lead >= 0xc2 && lead <= 0xdf) size = 2;
+            else if (lead >= 0xe0 && lead <= 0xef) size = 3;
+            else if (lead >= 0xf0 && lead <= 0xf4) size = 4;
+            else return false;
+
+            if (i + size > string.size()) return false;
+
+            if (size > 1) {
+                code_point = lead & (0x7f >> size);
+
+                for (auto j = 1ul; j < size; ++j) {
+                    const auto byte = static_cast<unsigned char>(string[i + j]);
+                    if ((byte & 0xc0) != 0x80) return false;
+                    code_point = (code_point << 6) | (byte & 0x3f);
+                }
+
+                constexpr auto min =
+                    std::array {0u, 0u, 0x80u, 0x800u, 0x10000u};
+
+                if (code_point < min[size] || code_point > 0x10ffff ||
+                    (code_point >= 0xd800 && code_point <= 0xdfff)) {
+                    return false;
+                }
+            }
+
+            i += size;
+        }
+
+        return true;
+    }
+}
+
+TEST(Utf8, Valid) {
+    EXPECT_TRUE(ext::utf8::validate(""));
+    EXPECT_TRUE(ext::utf8::validate("hello"));
+    EXPECT_TRUE(ext::utf8::validate("‘quoted‘"));
+    EXPECT_TRUE(ext::utf8::validate("\xc2\x80 \xdf\xbf"));
+    EXPECT_TRUE(ext::utf8::validate("\xe0\xa0\x80 \xed\x9f\xbf \xef\xbf\xbf"));
+    EXPECT_TRUE(ext::utf8::validate("\xf0\x90\x80\x80 \xf4\x8f\xbf\xbf"));
+}
+
+TEST(Utf8, Invalid) {
+    // Lone continuation byte.
+    EXPECT_FALSE(ext::utf8::validate("\x80"));
+    // Overlong encodings.
+    EXPECT_FALSE(ext::utf8::validate("\xc0\xaf"));
+    EXPECT_FALSE(ext::utf8::validate("\xe0\x80\xaf"));
+    EXPECT_FALSE(ext::utf8::validate("\xf0\x80\x80\xaf"));
+    // Surrogate.
+    EXPECT_FALSE(ext::utf8::validate("\xed\xa0\x80"));
+    // Beyond U+10FFFF.
+    EXPECT_FALSE(ext::utf8::validate("\xf4\x90\x80\x80"));
+    EXPECT_FALSE(ext::utf8::validate("\xf8\x88\x80\x80\x80"));
+    // Truncated sequences.
+    EXPECT_FALSE(ext::utf8::validate("\xe2\x82"));
+    EXPECT_FALSE(ext::utf8::validate("abc\xf0\x9f\x98"));
+    EXPECT_FALSE(ext::utf8::validate("\xe2\x82x"));
+}
+
+TEST(Utf8, ErrorAtEveryPosition) {
+    const auto valid = std::string(100, 'a') + "é€😀" + std::string(100, 'b');
+    ASSERT_TRUE(ext::utf8::validate(valid));
+
+    for (auto i = 0ul; i < valid.size(); ++i) {
+        auto invalid = valid;
+        invalid[i] = '\xff';
+        EXPECT_FALSE(ext::utf8::validate(invalid)) << "position " << i;
+
+        // A truncated prefix ends in the middle of a sequence whenever it
+        // cuts through one of the multibyte characters.
+        const auto prefix = std::string_view(valid).substr(0, i);
+        EXPECT_EQ(reference_validate(prefix), ext::utf8::validate(prefix))
+            << "length " << i;
+    }
+}
+
+TEST(Utf8, Random) {
+    auto engine = std::mt19937(7);
+    auto length = std::uniform_int_distribution<std::size_t>(0, 100);
+    auto byte = std::uniform_int_distribution<int>(0, 255);
+    auto pieces = std::array {
+        "a"sv,
+        "\x7f"sv,
+        "\xc3\xa9"sv,
+        "\xe2\x82\xac"sv,
+        "\xf0\x9f\x98\x80"sv,
+        "\xed\x9f\xbf"sv};
+    auto piece =
+        std::uniform_int_distribution<std::size_t>(0, pieces.size() - 1);
+
+    for (auto i = 0; i < 2000; ++i) {
+        auto string = std::string();
+        const auto count = length(engine);
+
+        for (auto j = 0ul; j < count; ++j) string += pieces[piece(engine)];
+
+        // Corrupt about half of the strings with a random byte.
+        if (i % 2 == 1 && !string.empty()) {
+            string[byte(engine) % string.size()] =
+                static_cast<char>(byte(engine));
+        }
+
+        ASSERT_EQ(reference_validate(string), ext::utf8::validate(string))
+            << testing::PrintToString(string);
+    }
+}
+
+TEST(Utf8, Length) {
+    EXPECT_EQ(0, ext::utf8::length(""));
+    EXPECT_EQ(5, ext::utf8::length("hello"));
+    EXPECT_EQ(4, ext::utf8::length("é€😀x"));
+
+    auto string = std::string();
+    for (auto i = 0; i < 50; ++i) string += "añb€";
+    EXPECT_EQ(200, ext::utf8::length(string));
+}
+
+TEST(Utf8, IsAscii) {
+    EXPECT_TRUE(ext::utf8::is_ascii(""));
+    EXPECT_TRUE(ext::utf8::is_ascii(std::string(100, 'x')));
+    EXPECT_FALSE(ext::utf8::is_ascii(std::string(100, 'x') + "é"));
+    EXPECT_FALSE(ext::utf8::is_ascii("é" + std::string(100, 'x')));
+}